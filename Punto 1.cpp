@@ -1,16 +1,67 @@
 #include <iostream>
 #include <cmath>
+#include <cstddef>   // Para size_t
+#include <new>       // Para reservas de memoria alineadas
+#include <algorithm>
+#include <vector>
+#include <iterator>
+#include <optional>
+#include <cfloat>    // Para FLT_MIN y FLT_MAX
+#include <thread>
+#include <utility>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h> // Intrínsecos AVX2 / AVX-512
+#define VECTOR3D_X86 1
+#endif
 using namespace std;
 
+// Precisión de la normalización:
+//  EXACTA: raíz cuadrada y división, igual que normalizar().
+//  ALTA:   estimación de 1/sqrt más dos pasos de Newton (error relativo < 1e-13).
+//  RAPIDA: estimación de 1/sqrt más un paso de Newton (error relativo < 1e-6).
+enum class PrecisionNormalizacion { EXACTA, ALTA, RAPIDA };
+
+// Aproximación de 1/sqrt(n2) para n2 > 0 finito: estimación de hardware (rsqrtss, 12 bits)
+// refinada con 'pasos' iteraciones de Newton. Fuera del rango normal de float se calcula
+// de forma exacta.
+inline double inversaRaizRapida(double n2, int pasos) noexcept {
+#ifdef VECTOR3D_X86
+    if (n2 >= FLT_MIN && n2 <= FLT_MAX) {
+        double r = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(float(n2))));
+        double h = 0.5 * n2;
+        for (int i = 0; i < pasos; ++i)
+            r = r * (1.5 - h * r * r);
+        return r;
+    }
+#else
+    (void)pasos;
+#endif
+    return 1.0 / sqrt(n2);
+}
+
 class Vector3D {
 private:
     double x, y, z; // Coordenadas del vector
 
 public:
     // Constructor que inicializa las coordenadas
-    Vector3D(double x_=0, double y_=0, double z_=0)
+    constexpr Vector3D(double x_=0, double y_=0, double z_=0) noexcept
         : x(x_), y(y_), z(z_) {}
 
+    // Métodos de acceso a las coordenadas
+    constexpr double obtenerX() const noexcept { return x; }
+    constexpr double obtenerY() const noexcept { return y; }
+    constexpr double obtenerZ() const noexcept { return z; }
+
+    // Acceso por índice: 0 -> x, 1 -> y, 2 -> z
+    constexpr double operator[](int i) const noexcept {
+        return i == 0 ? x : (i == 1 ? y : z);
+    }
+
+    constexpr double& operator[](int i) noexcept {
+        return i == 0 ? x : (i == 1 ? y : z);
+    }
+
     // Método para calcular la magnitud del vector
     double magnitud() const {
         return sqrt(x*x + y*y + z*z);
@@ -18,32 +69,1011 @@ public:
 
     // Método para normalizar el vector
     void normalizar() {
-        double mag = magnitud();
-        if (mag != 0) {
+        if (!normalizarSeguro())
+            cout << "No se puede normalizar un vector nulo." << endl;
+    }
+
+    // Normaliza sin escribir en consola ni lanzar excepciones. Devuelve false si el
+    // vector es nulo, en cuyo caso no se modifica.
+    bool normalizarSeguro(PrecisionNormalizacion p = PrecisionNormalizacion::EXACTA) noexcept {
+        double n2 = x*x + y*y + z*z;
+        if (n2 == 0)
+            return false;
+        if (p == PrecisionNormalizacion::EXACTA) {
+            double mag = sqrt(n2);
             x /= mag;
             y /= mag;
             z /= mag;
         } else {
-            cout << "No se puede normalizar un vector nulo." << endl;
+            double inv = inversaRaizRapida(n2, p == PrecisionNormalizacion::ALTA ? 2 : 1);
+            x *= inv;
+            y *= inv;
+            z *= inv;
         }
+        return true;
+    }
+
+    // Copia normalizada del vector, o nullopt si es nulo
+    optional<Vector3D> normalizado(PrecisionNormalizacion p = PrecisionNormalizacion::EXACTA) const noexcept {
+        Vector3D v = *this;
+        if (!v.normalizarSeguro(p))
+            return nullopt;
+        return v;
     }
 
     // Sobrecarga del operador suma (+)
-    Vector3D operator+(const Vector3D& v) const {
+    constexpr Vector3D operator+(const Vector3D& v) const noexcept {
         return Vector3D(x + v.x, y + v.y, z + v.z);
     }
 
     // Sobrecarga del operador resta (-)
-    Vector3D operator-(const Vector3D& v) const {
+    constexpr Vector3D operator-(const Vector3D& v) const noexcept {
         return Vector3D(x - v.x, y - v.y, z - v.z);
     }
 
+    // Vector opuesto
+    constexpr Vector3D operator-() const noexcept {
+        return Vector3D(-x, -y, -z);
+    }
+
     // Sobrecarga del operador * para producto escalar
-    double operator*(const Vector3D& v) const {
+    constexpr double operator*(const Vector3D& v) const noexcept {
         return x*v.x + y*v.y + z*v.z;
     }
 
+    // Multiplicación por un escalar (v * k y k * v)
+    constexpr Vector3D operator*(double k) const noexcept {
+        return Vector3D(x * k, y * k, z * k);
+    }
+
+    friend constexpr Vector3D operator*(double k, const Vector3D& v) noexcept {
+        return v * k;
+    }
+
+    // Operadores compuestos: modifican el vector en su sitio sin crear temporales
+    constexpr Vector3D& operator+=(const Vector3D& v) noexcept {
+        x += v.x;
+        y += v.y;
+        z += v.z;
+        return *this;
+    }
+
+    constexpr Vector3D& operator-=(const Vector3D& v) noexcept {
+        x -= v.x;
+        y -= v.y;
+        z -= v.z;
+        return *this;
+    }
+
+    constexpr Vector3D& operator*=(double k) noexcept {
+        x *= k;
+        y *= k;
+        z *= k;
+        return *this;
+    }
+
+    constexpr bool operator==(const Vector3D& v) const noexcept {
+        return x == v.x && y == v.y && z == v.z;
+    }
+
+    constexpr bool operator!=(const Vector3D& v) const noexcept {
+        return !(*this == v);
+    }
+
+    // Producto vectorial (cruz)
+    constexpr Vector3D cruz(const Vector3D& v) const noexcept {
+        return Vector3D(y*v.z - z*v.y, z*v.x - x*v.z, x*v.y - y*v.x);
+    }
+
+    // Interpolación lineal: t = 0 da este vector y t = 1 da v exactamente
+    constexpr Vector3D interpolar(const Vector3D& v, double t) const noexcept {
+        return Vector3D((1 - t)*x + t*v.x, (1 - t)*y + t*v.y, (1 - t)*z + t*v.z);
+    }
+
+    // Cuadrado de la distancia a v (evita la raíz cuadrada al comparar distancias)
+    constexpr double distanciaCuadrada(const Vector3D& v) const noexcept {
+        double dx = x - v.x, dy = y - v.y, dz = z - v.z;
+        return dx*dx + dy*dy + dz*dz;
+    }
+
     // Método para imprimir las coordenadas
     void imprimir() const {
         cout << "(" << x << ", " << y << ", " << z << ")" << endl;
     }
+};
+
+// Comprobaciones en tiempo de compilación del álgebra constexpr de Vector3D.
+// Los operadores compuestos se ejercitan dentro de una función constexpr.
+constexpr Vector3D operadoresCompuestos() noexcept {
+    Vector3D v(1, 2, 3);
+    v += Vector3D(1, 1, 1);   // (2, 3, 4)
+    v -= Vector3D(0, 1, 2);   // (2, 2, 2)
+    v *= 1.5;                 // (3, 3, 3)
+    v[2] = 6;                 // (3, 3, 6)
+    return v;
+}
+
+static_assert(Vector3D() == Vector3D(0, 0, 0), "constructor por defecto");
+static_assert(Vector3D(1, 2, 3).obtenerX() == 1 && Vector3D(1, 2, 3).obtenerY() == 2 &&
+              Vector3D(1, 2, 3).obtenerZ() == 3, "constructor y accesores");
+static_assert(Vector3D(1, 2, 3)[0] == 1 && Vector3D(1, 2, 3)[2] == 3, "acceso por índice");
+static_assert(Vector3D(1, 2, 3) + Vector3D(4, 5, 6) == Vector3D(5, 7, 9), "suma");
+static_assert(Vector3D(4, 5, 6) - Vector3D(1, 2, 3) == Vector3D(3, 3, 3), "resta");
+static_assert(-Vector3D(1, -2, 3) == Vector3D(-1, 2, -3), "opuesto");
+static_assert(Vector3D(1, 2, 3) * Vector3D(4, 5, 6) == 32, "producto escalar");
+static_assert(Vector3D(1, 2, 3) * 2.0 == Vector3D(2, 4, 6) &&
+              2.0 * Vector3D(1, 2, 3) == Vector3D(2, 4, 6), "producto por escalar");
+static_assert(Vector3D(1, 0, 0).cruz(Vector3D(0, 1, 0)) == Vector3D(0, 0, 1), "cruz de la base");
+static_assert(Vector3D(1, 2, 3).cruz(Vector3D(4, 5, 6)) == Vector3D(-3, 6, -3), "producto vectorial");
+static_assert(operadoresCompuestos() == Vector3D(3, 3, 6), "operadores compuestos");
+static_assert(Vector3D(1, 2, 3) != Vector3D(1, 2, 4), "desigualdad");
+static_assert(Vector3D(0, 0, 0).interpolar(Vector3D(2, 4, 6), 0.5) == Vector3D(1, 2, 3), "interpolación");
+static_assert(Vector3D(1, 1, 1).distanciaCuadrada(Vector3D(2, 3, 4)) == 14, "distancia al cuadrado");
+
+// -----------------------------------------------------------------------------
+// Núcleos de Vector3DBatch con despacho en tiempo de ejecución: versión escalar
+// portable y, en x86, versiones AVX2 y AVX-512 elegidas según la CPU al arrancar.
+// Trabajan sobre arreglos separados de x, y, z (estructura de arreglos).
+// -----------------------------------------------------------------------------
+class NucleosVector3D {
+public:
+    struct Tabla {
+        // o[i] = a[i] + b[i] / a[i] - b[i] sobre un arreglo de componentes
+        void (*suma)(const double* a, const double* b, double* o, size_t n);
+        void (*resta)(const double* a, const double* b, double* o, size_t n);
+        // o[i] = producto escalar de los vectores i
+        void (*punto)(const double* ax, const double* ay, const double* az,
+                      const double* bx, const double* by, const double* bz, double* o, size_t n);
+        // o[i] = magnitud del vector i
+        void (*magnitud)(const double* x, const double* y, const double* z, double* o, size_t n);
+        // Normalizan en su sitio; los vectores nulos quedan como están y se devuelve
+        // cuántos había. La versión rápida usa 1/sqrt aproximada más 'pasos' de Newton
+        size_t (*normalizar)(double* x, double* y, double* z, size_t n);
+        size_t (*normalizarRapida)(double* x, double* y, double* z, size_t n, int pasos);
+    };
+
+    static const Tabla& tabla() {
+        static const Tabla t = elegir();
+        return t;
+    }
+
+private:
+    static Tabla elegir() {
+#ifdef VECTOR3D_X86
+        if (__builtin_cpu_supports("avx512f"))
+            return {sumaAvx512, restaAvx512, puntoAvx512, magnitudAvx512, normalizarAvx512, normalizarRapidaAvx512};
+        if (__builtin_cpu_supports("avx2"))
+            return {sumaAvx2, restaAvx2, puntoAvx2, magnitudAvx2, normalizarAvx2, normalizarRapidaAvx2};
+#endif
+        return {sumaEscalar, restaEscalar, puntoEscalar, magnitudEscalar, normalizarEscalar,
+                normalizarRapidaEscalar};
+    }
+
+    // ------------------------------- Escalar -------------------------------
+
+    static void sumaEscalar(const double* a, const double* b, double* o, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            o[i] = a[i] + b[i];
+    }
+
+    static void restaEscalar(const double* a, const double* b, double* o, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            o[i] = a[i] - b[i];
+    }
+
+    static void puntoEscalar(const double* ax, const double* ay, const double* az,
+                             const double* bx, const double* by, const double* bz, double* o, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            o[i] = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i];
+    }
+
+    static void magnitudEscalar(const double* x, const double* y, const double* z, double* o, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            o[i] = sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+    }
+
+    static size_t normalizarEscalar(double* x, double* y, double* z, size_t n) {
+        size_t nulos = 0;
+        for (size_t i = 0; i < n; ++i) {
+            double mag = sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+            if (mag != 0) {
+                x[i] /= mag;
+                y[i] /= mag;
+                z[i] /= mag;
+            } else {
+                ++nulos;
+            }
+        }
+        return nulos;
+    }
+
+    static size_t normalizarRapidaEscalar(double* x, double* y, double* z, size_t n, int pasos) {
+        size_t nulos = 0;
+        for (size_t i = 0; i < n; ++i) {
+            double n2 = x[i] * x[i] + y[i] * y[i] + z[i] * z[i];
+            if (n2 == 0) {
+                ++nulos;
+                continue;
+            }
+            double inv = inversaRaizRapida(n2, pasos);
+            x[i] *= inv;
+            y[i] *= inv;
+            z[i] *= inv;
+        }
+        return nulos;
+    }
+
+#ifdef VECTOR3D_X86
+    // --------------------------------- AVX2 ---------------------------------
+    // target("avx2") no activa FMA, así que las operaciones se hacen en el mismo
+    // orden y con el mismo redondeo que en Vector3D y el resultado coincide bit a bit
+    // con la versión escalar. Si todo el archivo se compila con -mfma o -march=native
+    // el compilador puede fusionar mul + add (aquí o en la escalar) y diferir en 1 ulp.
+
+    __attribute__((target("avx2")))
+    static void sumaAvx2(const double* a, const double* b, double* o, size_t n) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(o + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+        sumaEscalar(a + i, b + i, o + i, n - i);
+    }
+
+    __attribute__((target("avx2")))
+    static void restaAvx2(const double* a, const double* b, double* o, size_t n) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(o + i, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+        restaEscalar(a + i, b + i, o + i, n - i);
+    }
+
+    __attribute__((target("avx2")))
+    static __m256d norma2Avx2(__m256d x, __m256d y, __m256d z) {
+        return _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)), _mm256_mul_pd(z, z));
+    }
+
+    __attribute__((target("avx2")))
+    static void puntoAvx2(const double* ax, const double* ay, const double* az,
+                          const double* bx, const double* by, const double* bz, double* o, size_t n) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d px = _mm256_mul_pd(_mm256_loadu_pd(ax + i), _mm256_loadu_pd(bx + i));
+            __m256d py = _mm256_mul_pd(_mm256_loadu_pd(ay + i), _mm256_loadu_pd(by + i));
+            __m256d pz = _mm256_mul_pd(_mm256_loadu_pd(az + i), _mm256_loadu_pd(bz + i));
+            _mm256_storeu_pd(o + i, _mm256_add_pd(_mm256_add_pd(px, py), pz));
+        }
+        puntoEscalar(ax + i, ay + i, az + i, bx + i, by + i, bz + i, o + i, n - i);
+    }
+
+    __attribute__((target("avx2")))
+    static void magnitudAvx2(const double* x, const double* y, const double* z, double* o, size_t n) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(o + i, _mm256_sqrt_pd(norma2Avx2(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i),
+                                                              _mm256_loadu_pd(z + i))));
+        magnitudEscalar(x + i, y + i, z + i, o + i, n - i);
+    }
+
+    __attribute__((target("avx2")))
+    static size_t normalizarAvx2(double* x, double* y, double* z, size_t n) {
+        const __m256d uno = _mm256_set1_pd(1.0);
+        size_t nulos = 0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d vx = _mm256_loadu_pd(x + i), vy = _mm256_loadu_pd(y + i), vz = _mm256_loadu_pd(z + i);
+            __m256d mag = _mm256_sqrt_pd(norma2Avx2(vx, vy, vz));
+            // Los vectores nulos se dividen entre 1, así quedan intactos sin saltos
+            __m256d nulo = _mm256_cmp_pd(mag, _mm256_setzero_pd(), _CMP_EQ_OQ);
+            nulos += __builtin_popcount(_mm256_movemask_pd(nulo));
+            mag = _mm256_blendv_pd(mag, uno, nulo);
+            _mm256_storeu_pd(x + i, _mm256_div_pd(vx, mag));
+            _mm256_storeu_pd(y + i, _mm256_div_pd(vy, mag));
+            _mm256_storeu_pd(z + i, _mm256_div_pd(vz, mag));
+        }
+        return nulos + normalizarEscalar(x + i, y + i, z + i, n - i);
+    }
+
+    // La estimación de AVX2 es de precisión simple (12 bits): los bloques con algún
+    // vector nulo o con magnitud fuera del rango de float pasan por la versión escalar
+    __attribute__((target("avx2")))
+    static size_t normalizarRapidaAvx2(double* x, double* y, double* z, size_t n, int pasos) {
+        const __m256d minimo = _mm256_set1_pd(FLT_MIN), maximo = _mm256_set1_pd(FLT_MAX);
+        const __m256d medio = _mm256_set1_pd(0.5), unoMedio = _mm256_set1_pd(1.5);
+        size_t nulos = 0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d vx = _mm256_loadu_pd(x + i), vy = _mm256_loadu_pd(y + i), vz = _mm256_loadu_pd(z + i);
+            __m256d n2 = norma2Avx2(vx, vy, vz);
+            __m256d fuera = _mm256_or_pd(_mm256_cmp_pd(n2, minimo, _CMP_LT_OQ), _mm256_cmp_pd(n2, maximo, _CMP_GT_OQ));
+            if (_mm256_movemask_pd(fuera)) {
+                nulos += normalizarRapidaEscalar(x + i, y + i, z + i, 4, pasos);
+                continue;
+            }
+            __m256d r = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(n2)));
+            __m256d h = _mm256_mul_pd(medio, n2);
+            for (int k = 0; k < pasos; ++k)
+                r = _mm256_mul_pd(r, _mm256_sub_pd(unoMedio, _mm256_mul_pd(h, _mm256_mul_pd(r, r))));
+            _mm256_storeu_pd(x + i, _mm256_mul_pd(vx, r));
+            _mm256_storeu_pd(y + i, _mm256_mul_pd(vy, r));
+            _mm256_storeu_pd(z + i, _mm256_mul_pd(vz, r));
+        }
+        return nulos + normalizarRapidaEscalar(x + i, y + i, z + i, n - i, pasos);
+    }
+
+    // ------------------------------- AVX-512 --------------------------------
+    // La cola se resuelve con máscaras en lugar de un bucle escalar. Se usan las
+    // variantes maskz con máscara completa porque _mm512_sqrt_pd de GCC 12 dispara
+    // un falso aviso de variable sin inicializar. target("avx512f") sí incluye FMA:
+    // en producto escalar, magnitud y normalización el compilador fusiona mul + add
+    // y el resultado puede diferir en la última cifra (1 ulp) de la versión escalar.
+
+    __attribute__((target("avx512f")))
+    static __mmask8 mascaraCola(size_t resto) {
+        return __mmask8(resto >= 8 ? 0xFF : (1u << resto) - 1);
+    }
+
+    __attribute__((target("avx512f")))
+    static void sumaAvx512(const double* a, const double* b, double* o, size_t n) {
+        for (size_t i = 0; i < n; i += 8) {
+            __mmask8 m = mascaraCola(n - i);
+            _mm512_mask_storeu_pd(o + i, m, _mm512_add_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i)));
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    static void restaAvx512(const double* a, const double* b, double* o, size_t n) {
+        for (size_t i = 0; i < n; i += 8) {
+            __mmask8 m = mascaraCola(n - i);
+            _mm512_mask_storeu_pd(o + i, m, _mm512_sub_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i)));
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    static void puntoAvx512(const double* ax, const double* ay, const double* az,
+                            const double* bx, const double* by, const double* bz, double* o, size_t n) {
+        for (size_t i = 0; i < n; i += 8) {
+            __mmask8 m = mascaraCola(n - i);
+            __m512d px = _mm512_mul_pd(_mm512_maskz_loadu_pd(m, ax + i), _mm512_maskz_loadu_pd(m, bx + i));
+            __m512d py = _mm512_mul_pd(_mm512_maskz_loadu_pd(m, ay + i), _mm512_maskz_loadu_pd(m, by + i));
+            __m512d pz = _mm512_mul_pd(_mm512_maskz_loadu_pd(m, az + i), _mm512_maskz_loadu_pd(m, bz + i));
+            _mm512_mask_storeu_pd(o + i, m, _mm512_add_pd(_mm512_add_pd(px, py), pz));
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    static void magnitudAvx512(const double* x, const double* y, const double* z, double* o, size_t n) {
+        for (size_t i = 0; i < n; i += 8) {
+            __mmask8 m = mascaraCola(n - i);
+            __m512d vx = _mm512_maskz_loadu_pd(m, x + i), vy = _mm512_maskz_loadu_pd(m, y + i), vz = _mm512_maskz_loadu_pd(m, z + i);
+            __m512d n2 = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(vx, vx), _mm512_mul_pd(vy, vy)), _mm512_mul_pd(vz, vz));
+            _mm512_mask_storeu_pd(o + i, m, _mm512_maskz_sqrt_pd(0xFF, n2));
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    static size_t normalizarAvx512(double* x, double* y, double* z, size_t n) {
+        size_t nulos = 0;
+        for (size_t i = 0; i < n; i += 8) {
+            __mmask8 m = mascaraCola(n - i);
+            __m512d vx = _mm512_maskz_loadu_pd(m, x + i), vy = _mm512_maskz_loadu_pd(m, y + i), vz = _mm512_maskz_loadu_pd(m, z + i);
+            __m512d n2 = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(vx, vx), _mm512_mul_pd(vy, vy)), _mm512_mul_pd(vz, vz));
+            // Solo se escriben los vectores válidos y no nulos. La máscara de nulos se
+            // construye con n2 == 0, como en las versiones escalar y AVX2, para que una
+            // norma NaN no cuente como vector nulo
+            __mmask8 nulo = _mm512_mask_cmp_pd_mask(m, n2, _mm512_setzero_pd(), _CMP_EQ_OQ);
+            __mmask8 validos = __mmask8(m & ~nulo);
+            nulos += __builtin_popcount(nulo);
+            __m512d mag = _mm512_maskz_sqrt_pd(0xFF, n2);
+            _mm512_mask_storeu_pd(x + i, validos, _mm512_div_pd(vx, mag));
+            _mm512_mask_storeu_pd(y + i, validos, _mm512_div_pd(vy, mag));
+            _mm512_mask_storeu_pd(z + i, validos, _mm512_div_pd(vz, mag));
+        }
+        return nulos;
+    }
+
+    // vrsqrt14pd da 14 bits en doble precisión en todo el rango, sin caso especial
+    __attribute__((target("avx512f")))
+    static size_t normalizarRapidaAvx512(double* x, double* y, double* z, size_t n, int pasos) {
+        const __m512d medio = _mm512_set1_pd(0.5), unoMedio = _mm512_set1_pd(1.5);
+        size_t nulos = 0;
+        for (size_t i = 0; i < n; i += 8) {
+            __mmask8 m = mascaraCola(n - i);
+            __m512d vx = _mm512_maskz_loadu_pd(m, x + i), vy = _mm512_maskz_loadu_pd(m, y + i), vz = _mm512_maskz_loadu_pd(m, z + i);
+            __m512d n2 = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(vx, vx), _mm512_mul_pd(vy, vy)), _mm512_mul_pd(vz, vz));
+            __mmask8 nulo = _mm512_mask_cmp_pd_mask(m, n2, _mm512_setzero_pd(), _CMP_EQ_OQ);
+            __mmask8 validos = __mmask8(m & ~nulo);
+            nulos += __builtin_popcount(nulo);
+            __m512d r = _mm512_maskz_rsqrt14_pd(0xFF, n2);
+            __m512d h = _mm512_mul_pd(medio, n2);
+            for (int k = 0; k < pasos; ++k)
+                r = _mm512_mul_pd(r, _mm512_sub_pd(unoMedio, _mm512_mul_pd(h, _mm512_mul_pd(r, r))));
+            _mm512_mask_storeu_pd(x + i, validos, _mm512_mul_pd(vx, r));
+            _mm512_mask_storeu_pd(y + i, validos, _mm512_mul_pd(vy, r));
+            _mm512_mask_storeu_pd(z + i, validos, _mm512_mul_pd(vz, r));
+        }
+        return nulos;
+    }
+#endif
+};
+
+// -----------------------------------------------------------------------------
+// Lote de vectores 3D en estructura de arreglos (SoA): las coordenadas x, y, z
+// de todos los vectores viven en tres arreglos separados y alineados, de modo que
+// las operaciones en bloque recorren memoria contigua con instrucciones SIMD.
+// -----------------------------------------------------------------------------
+class Vector3DBatch {
+private:
+    size_t n = 0;           // Número de vectores
+    size_t capacidad = 0;
+    double* x = nullptr;
+    double* y = nullptr;
+    double* z = nullptr;
+
+    static double* reservar(size_t cantidad) {
+        return static_cast<double*>(::operator new[](max<size_t>(cantidad, 1) * sizeof(double), align_val_t(64)));
+    }
+
+    static void liberar(double* p) {
+        ::operator delete[](p, align_val_t(64));
+    }
+
+    void reservarCapacidad(size_t nueva) {
+        double* nx = reservar(nueva);
+        double* ny = reservar(nueva);
+        double* nz = reservar(nueva);
+        copy(x, x + n, nx);
+        copy(y, y + n, ny);
+        copy(z, z + n, nz);
+        liberarTodo();
+        x = nx, y = ny, z = nz;
+        capacidad = nueva;
+    }
+
+    void liberarTodo() {
+        if (x) {
+            liberar(x);
+            liberar(y);
+            liberar(z);
+        }
+    }
+
+public:
+    // Vista sin copia sobre el lote: al desreferenciar devuelve un Vector3D por valor
+    class Iterador {
+    private:
+        const Vector3DBatch* lote;
+        size_t i;
+
+    public:
+        using iterator_category = forward_iterator_tag;
+        using value_type = Vector3D;
+        using difference_type = ptrdiff_t;
+        using pointer = void;
+        using reference = Vector3D;
+
+        Iterador(const Vector3DBatch* l, size_t pos) : lote(l), i(pos) {}
+        Vector3D operator*() const { return (*lote)[i]; }
+        Iterador& operator++() { ++i; return *this; }
+        Iterador operator++(int) { Iterador t = *this; ++i; return t; }
+        bool operator==(const Iterador& o) const { return i == o.i; }
+        bool operator!=(const Iterador& o) const { return i != o.i; }
+    };
+
+    // Constructor: lote de 'cantidad' vectores nulos
+    explicit Vector3DBatch(size_t cantidad = 0) {
+        reservarCapacidad(cantidad);
+        n = cantidad;
+        fill(x, x + n, 0.0);
+        fill(y, y + n, 0.0);
+        fill(z, z + n, 0.0);
+    }
+
+    // Constructor a partir de vectores sueltos (convierte de AoS a SoA)
+    explicit Vector3DBatch(const vector<Vector3D>& vectores) : Vector3DBatch(vectores.size()) {
+        for (size_t i = 0; i < n; ++i)
+            establecer(i, vectores[i]);
+    }
+
+    Vector3DBatch(const Vector3DBatch& otro) : Vector3DBatch() {
+        reservarCapacidad(otro.n);
+        n = otro.n;
+        copy(otro.x, otro.x + n, x);
+        copy(otro.y, otro.y + n, y);
+        copy(otro.z, otro.z + n, z);
+    }
+
+    Vector3DBatch(Vector3DBatch&& otro) noexcept
+        : n(otro.n), capacidad(otro.capacidad), x(otro.x), y(otro.y), z(otro.z) {
+        otro.n = otro.capacidad = 0;
+        otro.x = otro.y = otro.z = nullptr;
+    }
+
+    Vector3DBatch& operator=(Vector3DBatch otro) noexcept {
+        swap(n, otro.n);
+        swap(capacidad, otro.capacidad);
+        swap(x, otro.x);
+        swap(y, otro.y);
+        swap(z, otro.z);
+        return *this;
+    }
+
+    ~Vector3DBatch() {
+        liberarTodo();
+    }
+
+    size_t tamano() const {
+        return n;
+    }
+
+    // Acceso directo a los arreglos de coordenadas
+    const double* datosX() const { return x; }
+    const double* datosY() const { return y; }
+    const double* datosZ() const { return z; }
+    double* datosX() { return x; }
+    double* datosY() { return y; }
+    double* datosZ() { return z; }
+
+    // Devuelve el vector i por valor
+    Vector3D operator[](size_t i) const {
+        return Vector3D(x[i], y[i], z[i]);
+    }
+
+    void establecer(size_t i, const Vector3D& v) {
+        x[i] = v.obtenerX();
+        y[i] = v.obtenerY();
+        z[i] = v.obtenerZ();
+    }
+
+    // Añade un vector al final (crecimiento geométrico)
+    void agregar(const Vector3D& v) {
+        if (n == capacidad)
+            reservarCapacidad(max<size_t>(16, capacidad * 2));
+        ++n;
+        establecer(n - 1, v);
+    }
+
+    Iterador begin() const { return Iterador(this, 0); }
+    Iterador end() const { return Iterador(this, n); }
+
+    // Suma y resta en bloque sobre un lote de salida ya existente (sin reservar memoria);
+    // la salida puede ser uno de los operandos
+    void sumar(const Vector3DBatch& b, Vector3DBatch& salida) const {
+        const NucleosVector3D::Tabla& t = NucleosVector3D::tabla();
+        t.suma(x, b.x, salida.x, n);
+        t.suma(y, b.y, salida.y, n);
+        t.suma(z, b.z, salida.z, n);
+    }
+
+    void restar(const Vector3DBatch& b, Vector3DBatch& salida) const {
+        const NucleosVector3D::Tabla& t = NucleosVector3D::tabla();
+        t.resta(x, b.x, salida.x, n);
+        t.resta(y, b.y, salida.y, n);
+        t.resta(z, b.z, salida.z, n);
+    }
+
+    Vector3DBatch operator+(const Vector3DBatch& b) const {
+        Vector3DBatch r(n);
+        sumar(b, r);
+        return r;
+    }
+
+    Vector3DBatch operator-(const Vector3DBatch& b) const {
+        Vector3DBatch r(n);
+        restar(b, r);
+        return r;
+    }
+
+    // Productos escalares elemento a elemento: salida[i] = this[i] * b[i]
+    void punto(const Vector3DBatch& b, double* salida) const {
+        NucleosVector3D::tabla().punto(x, y, z, b.x, b.y, b.z, salida, n);
+    }
+
+    // Magnitudes de todos los vectores
+    void magnitudes(double* salida) const {
+        NucleosVector3D::tabla().magnitud(x, y, z, salida, n);
+    }
+
+    // Normaliza todos los vectores; los nulos quedan sin cambios y sin mensajes.
+    // Devuelve cuántos vectores nulos había
+    size_t normalizar(PrecisionNormalizacion p = PrecisionNormalizacion::EXACTA) {
+        const NucleosVector3D::Tabla& t = NucleosVector3D::tabla();
+        if (p == PrecisionNormalizacion::EXACTA)
+            return t.normalizar(x, y, z, n);
+        return t.normalizarRapida(x, y, z, n, p == PrecisionNormalizacion::ALTA ? 2 : 1);
+    }
+};
+
+// -----------------------------------------------------------------------------
+// Árbol k-d implícito sobre puntos Vector3D para consultas de vecinos.
+// Los puntos se reordenan en un solo arreglo: cada subárbol ocupa un rango
+// [inicio, fin), su nodo es el punto de la mediana y los rangos de hasta HOJA
+// puntos se recorren linealmente. El eje de corte es el de mayor extensión.
+// Construcción O(n log n), paralela en los niveles superiores.
+// -----------------------------------------------------------------------------
+class ArbolKD {
+private:
+    struct Punto {
+        Vector3D p;
+        size_t indice; // Posición en el conjunto original
+    };
+
+    static constexpr size_t HOJA = 16;            // Tamaño máximo de una hoja
+    static constexpr size_t MIN_PARALELO = 65536; // Subárbol mínimo para otro hilo
+
+    vector<Punto> puntos;
+    vector<unsigned char> ejes; // Eje de corte de cada nodo, indexado por su mediana
+
+    void construir(size_t inicio, size_t fin, unsigned hilos) {
+        if (fin - inicio <= HOJA)
+            return;
+
+        // Eje de mayor extensión dentro del rango
+        Vector3D minimo = puntos[inicio].p, maximo = puntos[inicio].p;
+        for (size_t i = inicio + 1; i < fin; ++i)
+            for (int e = 0; e < 3; ++e) {
+                minimo[e] = min(minimo[e], puntos[i].p[e]);
+                maximo[e] = max(maximo[e], puntos[i].p[e]);
+            }
+        Vector3D extension = maximo - minimo;
+        int eje = 0;
+        if (extension[1] > extension[eje]) eje = 1;
+        if (extension[2] > extension[eje]) eje = 2;
+
+        size_t medio = inicio + (fin - inicio) / 2;
+        nth_element(puntos.begin() + inicio, puntos.begin() + medio, puntos.begin() + fin,
+                    [eje](const Punto& a, const Punto& b) { return a.p[eje] < b.p[eje]; });
+        ejes[medio] = (unsigned char)eje;
+
+        // Las dos mitades son independientes: la izquierda puede ir en otro hilo
+        if (hilos > 1 && fin - inicio >= MIN_PARALELO) {
+            unsigned mitad = hilos / 2;
+            thread izquierda(&ArbolKD::construir, this, inicio, medio, mitad);
+            construir(medio + 1, fin, hilos - mitad);
+            izquierda.join();
+        } else {
+            construir(inicio, medio, 1);
+            construir(medio + 1, fin, 1);
+        }
+    }
+
+    void buscarRadio(size_t inicio, size_t fin, const Vector3D& c, double r2, vector<size_t>& salida) const {
+        if (fin - inicio <= HOJA) {
+            for (size_t i = inicio; i < fin; ++i)
+                if (puntos[i].p.distanciaCuadrada(c) <= r2)
+                    salida.push_back(puntos[i].indice);
+            return;
+        }
+        size_t medio = inicio + (fin - inicio) / 2;
+        int eje = ejes[medio];
+        double d = c[eje] - puntos[medio].p[eje];
+        if (puntos[medio].p.distanciaCuadrada(c) <= r2)
+            salida.push_back(puntos[medio].indice);
+        // Solo se baja a un lado si la esfera cruza el plano de corte
+        if (d <= 0 || d * d <= r2)
+            buscarRadio(inicio, medio, c, r2, salida);
+        if (d >= 0 || d * d <= r2)
+            buscarRadio(medio + 1, fin, c, r2, salida);
+    }
+
+    // 'mejores' es un montículo de máximos de (distancia², índice) con a lo sumo k elementos
+    void buscarVecinos(size_t inicio, size_t fin, const Vector3D& c, size_t k,
+                       vector<pair<double, size_t>>& mejores) const {
+        auto considerar = [&](const Punto& q) {
+            double d2 = q.p.distanciaCuadrada(c);
+            if (mejores.size() < k) {
+                mejores.emplace_back(d2, q.indice);
+                push_heap(mejores.begin(), mejores.end());
+            } else if (d2 < mejores.front().first) {
+                pop_heap(mejores.begin(), mejores.end());
+                mejores.back() = {d2, q.indice};
+                push_heap(mejores.begin(), mejores.end());
+            }
+        };
+        if (fin - inicio <= HOJA) {
+            for (size_t i = inicio; i < fin; ++i)
+                considerar(puntos[i]);
+            return;
+        }
+        size_t medio = inicio + (fin - inicio) / 2;
+        int eje = ejes[medio];
+        double d = c[eje] - puntos[medio].p[eje];
+        considerar(puntos[medio]);
+        // Primero el lado que contiene a c; el otro solo si puede mejorar el k-ésimo
+        if (d < 0) {
+            buscarVecinos(inicio, medio, c, k, mejores);
+            if (mejores.size() < k || d * d < mejores.front().first)
+                buscarVecinos(medio + 1, fin, c, k, mejores);
+        } else {
+            buscarVecinos(medio + 1, fin, c, k, mejores);
+            if (mejores.size() < k || d * d < mejores.front().first)
+                buscarVecinos(inicio, medio, c, k, mejores);
+        }
+    }
+
+    void iniciar(unsigned hilos) {
+        if (hilos == 0)
+            hilos = max(1u, thread::hardware_concurrency());
+        ejes.assign(puntos.size(), 0);
+        construir(0, puntos.size(), hilos);
+    }
+
+public:
+    // Construye el árbol; hilos = 0 usa todos los núcleos disponibles
+    explicit ArbolKD(const vector<Vector3D>& conjunto, unsigned hilos = 0) {
+        puntos.reserve(conjunto.size());
+        for (size_t i = 0; i < conjunto.size(); ++i)
+            puntos.push_back({conjunto[i], i});
+        iniciar(hilos);
+    }
+
+    explicit ArbolKD(const Vector3DBatch& lote, unsigned hilos = 0) {
+        puntos.reserve(lote.tamano());
+        for (size_t i = 0; i < lote.tamano(); ++i)
+            puntos.push_back({lote[i], i});
+        iniciar(hilos);
+    }
+
+    size_t tamano() const {
+        return puntos.size();
+    }
+
+    // Índices (en el conjunto original) de los puntos a distancia <= r de c, sin orden.
+    // La versión con salida reutiliza el vector del llamador y añade al final
+    void radio(const Vector3D& c, double r, vector<size_t>& salida) const {
+        if (!puntos.empty() && r >= 0)
+            buscarRadio(0, puntos.size(), c, r * r, salida);
+    }
+
+    vector<size_t> radio(const Vector3D& c, double r) const {
+        vector<size_t> salida;
+        radio(c, r, salida);
+        return salida;
+    }
+
+    // Índices de los k puntos más cercanos a c, del más cercano al más lejano
+    vector<size_t> vecinosCercanos(const Vector3D& c, size_t k) const {
+        vector<pair<double, size_t>> mejores;
+        k = min(k, puntos.size());
+        if (k == 0)
+            return {};
+        mejores.reserve(k + 1);
+        buscarVecinos(0, puntos.size(), c, k, mejores);
+        sort_heap(mejores.begin(), mejores.end());
+        vector<size_t> salida(mejores.size());
+        for (size_t i = 0; i < mejores.size(); ++i)
+            salida[i] = mejores[i].second;
+        return salida;
+    }
+};
+
+#ifdef VECTOR3D_PRUEBAS
+// Pruebas y mediciones. Se compilan con:
+//   g++ -std=c++17 -O2 -pthread -DVECTOR3D_PRUEBAS "Punto 1.cpp" -o pruebas
+// main devuelve 0 si todas las comprobaciones pasan; "./pruebas medir" ejecuta
+// además las mediciones de normalización y del árbol k-d.
+#include <chrono>
+#include <random>
+#include <string>
+#include <iomanip>
+
+static int fallos = 0;
+
+static void comprobar(bool condicion, const string& descripcion) {
+    cout << (condicion ? "[ok]    " : "[FALLO] ") << descripcion << endl;
+    if (!condicion)
+        ++fallos;
+}
+
+// El lote cuenta como nulos solo los vectores con norma cero, en todas las
+// precisiones y sea cual sea el núcleo elegido para la CPU; una norma NaN no es nula
+static void pruebaNormalizarLote() {
+    for (auto p : {PrecisionNormalizacion::EXACTA, PrecisionNormalizacion::ALTA, PrecisionNormalizacion::RAPIDA}) {
+        Vector3DBatch lote;
+        size_t nulos = 0;
+        for (int i = 0; i < 21; ++i) {
+            if (i % 3 == 0) {
+                lote.agregar(Vector3D());
+                ++nulos;
+            } else if (i % 7 == 1) {
+                lote.agregar(Vector3D(NAN, 0, 0));
+            } else {
+                lote.agregar(Vector3D(i, -2.0 * i, 0.5));
+            }
+        }
+        bool unitarios = true;
+        size_t contados = lote.normalizar(p);
+        for (size_t i = 0; i < lote.tamano(); ++i)
+            if (i % 3 != 0 && i % 7 != 1)
+                unitarios &= fabs(lote[i].magnitud() - 1) < 1e-6;
+        comprobar(contados == nulos && unitarios && lote[0] == Vector3D(),
+                  "normalizar lote, precisión " + to_string(int(p)));
+    }
+}
+
+// Operaciones del lote frente a las de Vector3D una a una, con una longitud que no
+// es múltiplo del ancho SIMD para pasar por la cola. Suma y resta son exactas; en
+// producto escalar y magnitud se admite la diferencia de 1 ulp por término de FMA
+static void pruebaLoteFrenteEscalar() {
+    mt19937 gen(3);
+    uniform_real_distribution<double> u(-10, 10);
+    for (size_t n : {size_t(1), size_t(7), size_t(37)}) {
+        vector<Vector3D> a(n), b(n);
+        for (size_t i = 0; i < n; ++i) {
+            a[i] = Vector3D(u(gen), u(gen), u(gen));
+            b[i] = Vector3D(u(gen), u(gen), u(gen));
+        }
+        Vector3DBatch la(a), lb(b), suma(n), resta(n);
+        la.sumar(lb, suma);
+        la.restar(lb, resta);
+        vector<double> puntos(n), magnitudes(n);
+        la.punto(lb, puntos.data());
+        la.magnitudes(magnitudes.data());
+
+        const double eps = DBL_EPSILON;
+        bool exactas = true, cercanas = true;
+        for (size_t i = 0; i < n; ++i) {
+            exactas &= suma[i] == a[i] + b[i] && resta[i] == a[i] - b[i];
+            double escala = fabs(a[i].obtenerX() * b[i].obtenerX()) + fabs(a[i].obtenerY() * b[i].obtenerY()) +
+                            fabs(a[i].obtenerZ() * b[i].obtenerZ());
+            cercanas &= fabs(puntos[i] - a[i] * b[i]) <= 2 * eps * escala;
+            cercanas &= fabs(magnitudes[i] - a[i].magnitud()) <= 2 * eps * a[i].magnitud();
+        }
+        comprobar(exactas, "sumar y restar del lote iguales a Vector3D, n = " + to_string(n));
+        comprobar(cercanas, "punto y magnitudes del lote iguales a Vector3D salvo 1 ulp, n = " + to_string(n));
+    }
+}
+
+// Consultas del árbol frente a la búsqueda exhaustiva, con puntos repetidos y
+// datos aplastados en un eje
+static void pruebaArbolKD() {
+    mt19937 gen(7);
+    uniform_real_distribution<double> u(0, 1);
+    const size_t n = 20000;
+    vector<Vector3D> puntos(n);
+    for (auto& v : puntos)
+        v = Vector3D(u(gen), 0.01 * u(gen), u(gen));
+    for (size_t i = 1; i < 100; ++i)
+        puntos[i] = puntos[0];
+
+    for (unsigned hilos : {1u, 4u}) {
+        ArbolKD arbol(puntos, hilos);
+        bool radioBien = true, vecinosBien = true;
+        for (int q = 0; q < 100; ++q) {
+            Vector3D c(u(gen), 0.01 * u(gen), u(gen));
+            double r = q == 0 ? 0.0 : 0.02 * u(gen);
+            if (q == 0)
+                c = puntos[0];
+
+            vector<size_t> obtenidos = arbol.radio(c, r), esperados;
+            sort(obtenidos.begin(), obtenidos.end());
+            for (size_t i = 0; i < n; ++i)
+                if (puntos[i].distanciaCuadrada(c) <= r * r)
+                    esperados.push_back(i);
+            radioBien &= obtenidos == esperados;
+
+            size_t k = 1 + q % 20;
+            vector<double> distancias(n);
+            for (size_t i = 0; i < n; ++i)
+                distancias[i] = puntos[i].distanciaCuadrada(c);
+            sort(distancias.begin(), distancias.end());
+            vector<size_t> vecinos = arbol.vecinosCercanos(c, k);
+            vecinosBien &= vecinos.size() == k;
+            for (size_t j = 0; j < vecinos.size(); ++j)
+                vecinosBien &= puntos[vecinos[j]].distanciaCuadrada(c) == distancias[j];
+        }
+        comprobar(radioBien, "radio() igual a la búsqueda exhaustiva, " + to_string(hilos) + " hilos");
+        comprobar(vecinosBien, "vecinosCercanos() igual a la búsqueda exhaustiva, " + to_string(hilos) + " hilos");
+    }
+
+    ArbolKD vacio(vector<Vector3D>{});
+    comprobar(vacio.radio(Vector3D(), 1).empty() && vacio.vecinosCercanos(Vector3D(), 3).empty(), "árbol vacío");
+    ArbolKD uno(vector<Vector3D>{Vector3D(1, 1, 1)});
+    comprobar(uno.vecinosCercanos(Vector3D(), 3).size() == 1, "k mayor que el número de puntos");
+}
+
+static double segundosDesde(chrono::steady_clock::time_point inicio) {
+    return chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+}
+
+// Construcción y consultas del árbol para 10^5 a 10^7 puntos uniformes en el cubo
+// unidad, frente al recorrido lineal con magnitud() que hacía falta sin índice.
+// El radio se elige para que cada consulta devuelva unos 125 puntos.
+static void medirArbolKD() {
+    mt19937 gen(11);
+    uniform_real_distribution<double> u(0, 1);
+    const int consultas = 10000, consultasLineales = 10;
+    cout << "\n       n   construir s   radio us   10 vecinos us   lineal us" << endl;
+    for (size_t n : {size_t(100000), size_t(1000000), size_t(10000000)}) {
+        vector<Vector3D> puntos(n);
+        for (auto& v : puntos)
+            v = Vector3D(u(gen), u(gen), u(gen));
+        double r = cbrt(30.0 / n);
+        size_t total = 0;
+
+        auto t0 = chrono::steady_clock::now();
+        ArbolKD arbol(puntos);
+        double construir = segundosDesde(t0);
+
+        vector<size_t> salida;
+        t0 = chrono::steady_clock::now();
+        for (int q = 0; q < consultas; ++q) {
+            salida.clear();
+            arbol.radio(Vector3D(u(gen), u(gen), u(gen)), r, salida);
+            total += salida.size();
+        }
+        double radio = segundosDesde(t0) / consultas;
+
+        t0 = chrono::steady_clock::now();
+        for (int q = 0; q < consultas; ++q)
+            total += arbol.vecinosCercanos(Vector3D(u(gen), u(gen), u(gen)), 10).size();
+        double vecinos = segundosDesde(t0) / consultas;
+
+        t0 = chrono::steady_clock::now();
+        for (int q = 0; q < consultasLineales; ++q) {
+            Vector3D c(u(gen), u(gen), u(gen));
+            for (const Vector3D& p : puntos)
+                total += (p - c).magnitud() <= r;
+        }
+        double lineal = segundosDesde(t0) / consultasLineales;
+
+        cout << setw(9) << n << fixed << setprecision(3) << setw(13) << construir
+             << setprecision(2) << setw(11) << radio * 1e6 << setw(16) << vecinos * 1e6
+             << setprecision(0) << setw(12) << lineal * 1e6 << "   (" << total << ")" << endl;
+    }
+}
+
+// normalizar() y normalizarSeguro() vector a vector frente a Vector3DBatch::normalizar
+// en cada precisión, sobre 10^6 vectores no nulos. normalizar() solo tiene la
+// precisión exacta. Se normalizan los mismos datos varias veces; el coste no
+// depende de que ya sean unitarios.
+static void medirNormalizar() {
+    const size_t n = 1000000;
+    const int repeticiones = 20;
+    mt19937 gen(13);
+    uniform_real_distribution<double> u(-1, 1);
+    vector<Vector3D> vectores(n);
+    for (auto& v : vectores)
+        v = Vector3D(u(gen), u(gen), 1.0 + u(gen) * u(gen));
+    Vector3DBatch lote(vectores);
+    const char* nombres[] = {"EXACTA", "ALTA", "RAPIDA"};
+
+    auto t0 = chrono::steady_clock::now();
+    for (int r = 0; r < repeticiones; ++r)
+        for (auto& v : vectores)
+            v.normalizar();
+    double simple = segundosDesde(t0) / repeticiones;
+
+    cout << "\n  precisión   normalizar() ns   normalizarSeguro ns   lote ns" << endl;
+    for (auto p : {PrecisionNormalizacion::EXACTA, PrecisionNormalizacion::ALTA, PrecisionNormalizacion::RAPIDA}) {
+        size_t nulos = 0;
+        t0 = chrono::steady_clock::now();
+        for (int r = 0; r < repeticiones; ++r)
+            for (auto& v : vectores)
+                nulos += !v.normalizarSeguro(p);
+        double seguro = segundosDesde(t0) / repeticiones;
+
+        t0 = chrono::steady_clock::now();
+        for (int r = 0; r < repeticiones; ++r)
+            nulos += lote.normalizar(p);
+        double enLote = segundosDesde(t0) / repeticiones;
+
+        cout << setw(11) << nombres[int(p)] << fixed << setprecision(2) << setw(18);
+        if (p == PrecisionNormalizacion::EXACTA)
+            cout << simple / n * 1e9;
+        else
+            cout << "-";
+        cout << setw(22) << seguro / n * 1e9 << setw(10) << enLote / n * 1e9 << "   (" << nulos << ")" << endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    pruebaNormalizarLote();
+    pruebaLoteFrenteEscalar();
+    pruebaArbolKD();
+    if (argc > 1 && string(argv[1]) == "medir") {
+        medirNormalizar();
+        medirArbolKD();
+    }
+    cout << (fallos == 0 ? "Todas las pruebas pasaron" : "Hay pruebas que fallaron") << endl;
+    return fallos == 0 ? 0 : 1;
+}
+#endif
@@ -2,77 +2,1187 @@
 #include <iomanip>   // Para formato de impresión
 #include <cstdlib>   // Para rand() y srand()
 #include <ctime>     // Para inicializar la semilla aleatoria
+#include <cstddef>   // Para size_t
+#include <new>       // Para reservas de memoria alineadas
+#include <algorithm> // Para min() y fill()
+#include <cmath>
+#include <cstdint>   // Para la cabecera del formato binario
+#include <climits>   // Para INT_MAX
+#include <cstring>
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>     // Para cargar matrices mapeando el archivo en memoria
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MATRIZ_MMAP 1
+#endif
+#include <vector>
+#include <array>     // Para las matrices de tamaño fijo
+#include <memory>    // Para unique_ptr
+#include <functional>
+#include <thread>    // Para el pool de hilos
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <type_traits> // Para las plantillas de expresiones
+#include <utility>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h> // Intrínsecos AVX2 / AVX-512
+#define MATRIZ_X86 1
+#endif
 using namespace std;
 
-class Matriz {
+// Pool de hilos persistente: los trabajadores se crean una vez y se reutilizan
+// en cada llamada a ejecutar(), evitando el costo de lanzar hilos por operación.
+class PoolHilos {
 private:
+    vector<thread> trabajadores;
+    mutex m;
+    condition_variable cvTrabajo;  // Despierta a los trabajadores en cada ronda
+    condition_variable cvFin;      // Avisa al llamador cuando la ronda termina
+    const function<void(int, int)>* tarea = nullptr;
+    int totalTareas = 0;
+    atomic<int> siguiente{0};      // Próxima tarea libre (reparto dinámico)
+    int activos = 0;               // Trabajadores que aún no terminan la ronda
+    unsigned long ronda = 0;
+    bool terminar = false;
+
+    // Toma tareas del contador compartido hasta agotarlas
+    void consumir(int id) {
+        int i;
+        while ((i = siguiente.fetch_add(1)) < totalTareas)
+            (*tarea)(i, id);
+    }
+
+    void bucleTrabajador(int id) {
+        unsigned long vista = 0;
+        unique_lock<mutex> lk(m);
+        while (true) {
+            cvTrabajo.wait(lk, [&] { return terminar || ronda != vista; });
+            if (terminar)
+                return;
+            vista = ronda;
+            lk.unlock();
+            consumir(id);
+            lk.lock();
+            if (--activos == 0)
+                cvFin.notify_one();
+        }
+    }
+
+public:
+    // Crea hilos - 1 trabajadores; el hilo que llama a ejecutar() actúa como el hilo 0
+    explicit PoolHilos(int hilos) {
+        for (int id = 1; id < hilos; ++id)
+            trabajadores.emplace_back([this, id] { bucleTrabajador(id); });
+    }
+
+    int tamano() const {
+        return int(trabajadores.size()) + 1;
+    }
+
+    // Ejecuta f(tarea, hilo) para tarea en [0, tareas) y espera a que todas terminen.
+    // No es reentrante: f no debe volver a llamar a ejecutar() sobre el mismo pool.
+    void ejecutar(int tareas, const function<void(int, int)>& f) {
+        if (trabajadores.empty() || tareas <= 1) {
+            for (int i = 0; i < tareas; ++i)
+                f(i, 0);
+            return;
+        }
+        {
+            lock_guard<mutex> lk(m);
+            tarea = &f;
+            totalTareas = tareas;
+            siguiente = 0;
+            activos = int(trabajadores.size());
+            ++ronda;
+        }
+        cvTrabajo.notify_all();
+        consumir(0);
+        unique_lock<mutex> lk(m);
+        cvFin.wait(lk, [&] { return activos == 0; });
+        tarea = nullptr;
+    }
+
+    ~PoolHilos() {
+        {
+            lock_guard<mutex> lk(m);
+            terminar = true;
+        }
+        cvTrabajo.notify_all();
+        for (auto& t : trabajadores)
+            t.join();
+    }
+};
+
+// Núcleos numéricos de Matriz con despacho en tiempo de ejecución.
+// Cada operación tiene una versión escalar portable y, en x86, versiones AVX2+FMA
+// y AVX-512 compiladas con atributos target; al arrancar se elige la mejor que
+// soporte la CPU, de modo que el mismo binario aprovecha ambos tipos de máquina.
+class NucleosMatriz {
+public:
+    // Micro-bloque de C acumulado en registros (MR filas x NR columnas).
+    // Con 6 x 8 el núcleo AVX2 usa 12 acumuladores ymm y el AVX-512 6 zmm.
+    static constexpr int MR = 6;
+    static constexpr int NR = 8;
+
+    enum Nivel { ESCALAR, AVX2, AVX512 };
+
+    struct Tabla {
+        Nivel nivel;
+        // C[m x nc] += Apanel[MR x kc] * Bpanel[kc x NR]
+        void (*micro)(int kc, const double* a, const double* b, double* C, int ldc, int m, int nc);
+        // c[i] = a[i] + b[i], c[i] = a[i] - b[i], c[i] = a[i] * k
+        void (*suma)(const double* a, const double* b, double* c, size_t len);
+        void (*resta)(const double* a, const double* b, double* c, size_t len);
+        void (*escala)(const double* a, double k, double* c, size_t len);
+        // Transpone un bloque ladoT x ladoT: dst[i * ldd + j] = src[j * lds + i]
+        void (*transponerBloque)(const double* src, int lds, double* dst, int ldd);
+        int ladoT;
+    };
+
+    // Nivel más alto soportado por la CPU actual
+    static Nivel nivelDisponible() {
+#ifdef MATRIZ_X86
+        if (__builtin_cpu_supports("avx512f"))
+            return AVX512;
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return AVX2;
+#endif
+        return ESCALAR;
+    }
+
+    static const Tabla& tabla() {
+        return activa();
+    }
+
+    // Fuerza un nivel (p. ej. ESCALAR para comparar resultados); se limita a lo que
+    // soporta la CPU. No debe llamarse mientras haya operaciones en curso.
+    static void seleccionar(Nivel nivel) {
+        activa() = construir(min(nivel, nivelDisponible()));
+    }
+
+private:
+    static Tabla& activa() {
+        static Tabla t = construir(nivelDisponible());
+        return t;
+    }
+
+    static Tabla construir(Nivel nivel) {
+#ifdef MATRIZ_X86
+        if (nivel == AVX512)
+            return {AVX512, microAvx512, sumaAvx512, restaAvx512, escalaAvx512, transponer8x8Avx512, 8};
+        if (nivel == AVX2)
+            return {AVX2, microAvx2, sumaAvx2, restaAvx2, escalaAvx2, transponer4x4Avx2, 4};
+#endif
+        (void)nivel;
+        return {ESCALAR, microEscalar, sumaEscalar, restaEscalar, escalaEscalar, transponer4x4Escalar, 4};
+    }
+
+    // ---------------------------- Versión escalar ----------------------------
+
+    static void microEscalar(int kc, const double* a, const double* b, double* C, int ldc, int m, int nc) {
+        double acc[MR][NR] = {};
+        for (int p = 0; p < kc; ++p) {
+            for (int i = 0; i < MR; ++i) {
+                double aip = a[i];
+                for (int j = 0; j < NR; ++j)
+                    acc[i][j] += aip * b[j];
+            }
+            a += MR;
+            b += NR;
+        }
+        for (int i = 0; i < m; ++i)
+            for (int j = 0; j < nc; ++j)
+                C[i * ldc + j] += acc[i][j];
+    }
+
+    static void sumaEscalar(const double* a, const double* b, double* c, size_t len) {
+        for (size_t i = 0; i < len; ++i)
+            c[i] = a[i] + b[i];
+    }
+
+    static void restaEscalar(const double* a, const double* b, double* c, size_t len) {
+        for (size_t i = 0; i < len; ++i)
+            c[i] = a[i] - b[i];
+    }
+
+    static void escalaEscalar(const double* a, double k, double* c, size_t len) {
+        for (size_t i = 0; i < len; ++i)
+            c[i] = a[i] * k;
+    }
+
+    static void transponer4x4Escalar(const double* src, int lds, double* dst, int ldd) {
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < 4; ++j)
+                dst[i * ldd + j] = src[j * lds + i];
+    }
+
+#ifdef MATRIZ_X86
+    // ------------------------------ AVX2 + FMA -------------------------------
+
+    __attribute__((target("avx2,fma")))
+    static void microAvx2(int kc, const double* a, const double* b, double* C, int ldc, int m, int nc) {
+        __m256d acc[MR][2];
+        for (int i = 0; i < MR; ++i)
+            acc[i][0] = acc[i][1] = _mm256_setzero_pd();
+        for (int p = 0; p < kc; ++p) {
+            __m256d b0 = _mm256_loadu_pd(b);
+            __m256d b1 = _mm256_loadu_pd(b + 4);
+            for (int i = 0; i < MR; ++i) {
+                __m256d ai = _mm256_broadcast_sd(a + i);
+                acc[i][0] = _mm256_fmadd_pd(ai, b0, acc[i][0]);
+                acc[i][1] = _mm256_fmadd_pd(ai, b1, acc[i][1]);
+            }
+            a += MR;
+            b += NR;
+        }
+        if (m == MR && nc == NR) {
+            for (int i = 0; i < MR; ++i) {
+                double* c = C + i * ldc;
+                _mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), acc[i][0]));
+                _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), acc[i][1]));
+            }
+            return;
+        }
+        // Borde: se vuelca el bloque y solo se suman las celdas válidas
+        double tmp[MR][NR];
+        for (int i = 0; i < MR; ++i) {
+            _mm256_storeu_pd(tmp[i], acc[i][0]);
+            _mm256_storeu_pd(tmp[i] + 4, acc[i][1]);
+        }
+        for (int i = 0; i < m; ++i)
+            for (int j = 0; j < nc; ++j)
+                C[i * ldc + j] += tmp[i][j];
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void sumaAvx2(const double* a, const double* b, double* c, size_t len) {
+        size_t i = 0;
+        for (; i + 4 <= len; i += 4)
+            _mm256_storeu_pd(c + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+        for (; i < len; ++i)
+            c[i] = a[i] + b[i];
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void restaAvx2(const double* a, const double* b, double* c, size_t len) {
+        size_t i = 0;
+        for (; i + 4 <= len; i += 4)
+            _mm256_storeu_pd(c + i, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+        for (; i < len; ++i)
+            c[i] = a[i] - b[i];
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void escalaAvx2(const double* a, double k, double* c, size_t len) {
+        __m256d vk = _mm256_set1_pd(k);
+        size_t i = 0;
+        for (; i + 4 <= len; i += 4)
+            _mm256_storeu_pd(c + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), vk));
+        for (; i < len; ++i)
+            c[i] = a[i] * k;
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void transponer4x4Avx2(const double* src, int lds, double* dst, int ldd) {
+        __m256d r0 = _mm256_loadu_pd(src);
+        __m256d r1 = _mm256_loadu_pd(src + lds);
+        __m256d r2 = _mm256_loadu_pd(src + 2 * lds);
+        __m256d r3 = _mm256_loadu_pd(src + 3 * lds);
+        __m256d t0 = _mm256_unpacklo_pd(r0, r1);  // a0 b0 a2 b2
+        __m256d t1 = _mm256_unpackhi_pd(r0, r1);  // a1 b1 a3 b3
+        __m256d t2 = _mm256_unpacklo_pd(r2, r3);  // c0 d0 c2 d2
+        __m256d t3 = _mm256_unpackhi_pd(r2, r3);  // c1 d1 c3 d3
+        _mm256_storeu_pd(dst, _mm256_permute2f128_pd(t0, t2, 0x20));
+        _mm256_storeu_pd(dst + ldd, _mm256_permute2f128_pd(t1, t3, 0x20));
+        _mm256_storeu_pd(dst + 2 * ldd, _mm256_permute2f128_pd(t0, t2, 0x31));
+        _mm256_storeu_pd(dst + 3 * ldd, _mm256_permute2f128_pd(t1, t3, 0x31));
+    }
+
+    // ------------------------------- AVX-512 ---------------------------------
+
+    __attribute__((target("avx512f")))
+    static void microAvx512(int kc, const double* a, const double* b, double* C, int ldc, int m, int nc) {
+        __m512d acc[MR];
+        for (int i = 0; i < MR; ++i)
+            acc[i] = _mm512_setzero_pd();
+        for (int p = 0; p < kc; ++p) {
+            __m512d bp = _mm512_loadu_pd(b);
+            for (int i = 0; i < MR; ++i)
+                acc[i] = _mm512_fmadd_pd(_mm512_set1_pd(a[i]), bp, acc[i]);
+            a += MR;
+            b += NR;
+        }
+        // Las columnas válidas se escriben con máscara; las filas sobrantes se omiten
+        __mmask8 mascara = __mmask8((1u << nc) - 1);
+        for (int i = 0; i < m; ++i) {
+            double* c = C + i * ldc;
+            _mm512_mask_storeu_pd(c, mascara, _mm512_add_pd(_mm512_maskz_loadu_pd(mascara, c), acc[i]));
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    static void sumaAvx512(const double* a, const double* b, double* c, size_t len) {
+        size_t i = 0;
+        for (; i + 8 <= len; i += 8)
+            _mm512_storeu_pd(c + i, _mm512_add_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+        __mmask8 r = __mmask8((1u << (len - i)) - 1);
+        _mm512_mask_storeu_pd(c + i, r, _mm512_add_pd(_mm512_maskz_loadu_pd(r, a + i), _mm512_maskz_loadu_pd(r, b + i)));
+    }
+
+    __attribute__((target("avx512f")))
+    static void restaAvx512(const double* a, const double* b, double* c, size_t len) {
+        size_t i = 0;
+        for (; i + 8 <= len; i += 8)
+            _mm512_storeu_pd(c + i, _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+        __mmask8 r = __mmask8((1u << (len - i)) - 1);
+        _mm512_mask_storeu_pd(c + i, r, _mm512_sub_pd(_mm512_maskz_loadu_pd(r, a + i), _mm512_maskz_loadu_pd(r, b + i)));
+    }
+
+    __attribute__((target("avx512f")))
+    static void escalaAvx512(const double* a, double k, double* c, size_t len) {
+        __m512d vk = _mm512_set1_pd(k);
+        size_t i = 0;
+        for (; i + 8 <= len; i += 8)
+            _mm512_storeu_pd(c + i, _mm512_mul_pd(_mm512_loadu_pd(a + i), vk));
+        __mmask8 r = __mmask8((1u << (len - i)) - 1);
+        _mm512_mask_storeu_pd(c + i, r, _mm512_mul_pd(_mm512_maskz_loadu_pd(r, a + i), vk));
+    }
+
+    __attribute__((target("avx512f")))
+    static void transponer8x8Avx512(const double* src, int lds, double* dst, int ldd) {
+        __m512d r[8], t[8], u[8];
+        for (int i = 0; i < 8; ++i)
+            r[i] = _mm512_loadu_pd(src + i * lds);
+        // Se usan las variantes maskz con máscara completa, equivalentes a las normales,
+        // para evitar un falso aviso de -Wuninitialized en los encabezados de GCC 12.
+        // Intercala pares de filas: t[2k] = pares, t[2k+1] = impares
+        for (int i = 0; i < 8; i += 2) {
+            t[i] = _mm512_maskz_unpacklo_pd(0xFF, r[i], r[i + 1]);
+            t[i + 1] = _mm512_maskz_unpackhi_pd(0xFF, r[i], r[i + 1]);
+        }
+        // Reúne carriles de 128 bits de dos en dos pares de filas
+        for (int i = 0; i < 8; i += 4) {
+            u[i] = _mm512_maskz_shuffle_f64x2(0xFF, t[i], t[i + 2], 0x88);          // columnas 0 y 4
+            u[i + 1] = _mm512_maskz_shuffle_f64x2(0xFF, t[i], t[i + 2], 0xDD);      // columnas 2 y 6
+            u[i + 2] = _mm512_maskz_shuffle_f64x2(0xFF, t[i + 1], t[i + 3], 0x88);  // columnas 1 y 5
+            u[i + 3] = _mm512_maskz_shuffle_f64x2(0xFF, t[i + 1], t[i + 3], 0xDD);  // columnas 3 y 7
+        }
+        _mm512_storeu_pd(dst, _mm512_maskz_shuffle_f64x2(0xFF, u[0], u[4], 0x88));
+        _mm512_storeu_pd(dst + 4 * ldd, _mm512_maskz_shuffle_f64x2(0xFF, u[0], u[4], 0xDD));
+        _mm512_storeu_pd(dst + 2 * ldd, _mm512_maskz_shuffle_f64x2(0xFF, u[1], u[5], 0x88));
+        _mm512_storeu_pd(dst + 6 * ldd, _mm512_maskz_shuffle_f64x2(0xFF, u[1], u[5], 0xDD));
+        _mm512_storeu_pd(dst + ldd, _mm512_maskz_shuffle_f64x2(0xFF, u[2], u[6], 0x88));
+        _mm512_storeu_pd(dst + 5 * ldd, _mm512_maskz_shuffle_f64x2(0xFF, u[2], u[6], 0xDD));
+        _mm512_storeu_pd(dst + 3 * ldd, _mm512_maskz_shuffle_f64x2(0xFF, u[3], u[7], 0x88));
+        _mm512_storeu_pd(dst + 7 * ldd, _mm512_maskz_shuffle_f64x2(0xFF, u[3], u[7], 0xDD));
+    }
+#endif
+};
+
+// Base CRTP de las expresiones perezosas sobre matrices (+, -, * escalar, * matriz, .T()).
+// Una expresión solo describe cómo obtener el elemento (i, j); se evalúa de una sola
+// pasada al construir o asignar una Matriz, sin temporales intermedios.
+template <class E>
+class ExprMatriz {
+public:
+    const E& derivada() const {
+        return static_cast<const E&>(*this);
+    }
+};
+
+template <class E> class TranspuestaExpr;
+
+class Matriz : public ExprMatriz<Matriz> {
+private:
+    friend class MatrizDispersa;
+    template <class> friend class MatrizDinamica;
+
     int n;          // Tamaño de la matriz (n x n)
-    double** datos; // Puntero doble para almacenar la matriz dinámicamente
+    double* datos;  // Buffer contiguo por filas: el elemento (i, j) está en datos[i * n + j]
+    void* mapeo = nullptr;      // Si no es nulo, datos apunta dentro de un archivo mapeado
+    size_t bytesMapeados = 0;
+
+    // Tamaños de bloque del núcleo de multiplicación.
+    // MR x NR es el micro-bloque de C que se acumula en registros;
+    // KC x NR (panel de B) cabe en L1, MC x KC (bloque de A) en L2 y KC x NC en L3.
+    static constexpr int MR = NucleosMatriz::MR;
+    static constexpr int NR = NucleosMatriz::NR;
+    static constexpr int MC = 96;
+    static constexpr int KC = 256;
+    static constexpr int NC = 2048;
+    static constexpr int TB = 32;  // Lado de la hoja de la transposición recursiva
+    static constexpr int FT = 128; // Filas por tarea al transponer en paralelo
+
+    // Configuración del modo paralelo, compartida por todas las matrices
+    // (atómicas porque se pueden cambiar mientras otros hilos multiplican)
+    inline static atomic<int> hilos{max(1, int(thread::hardware_concurrency()))};
+    inline static atomic<int> umbralParalelo{128};  // Por debajo de este n se usa el camino serial
+    inline static unique_ptr<PoolHilos> pool;
+    inline static atomic<bool> poolOcupado{false}; // Un solo usuario del pool a la vez
+    inline static atomic<int> corteStrassen{0}; // 0 = modo Strassen-Winograd desactivado
+
+    // Uso exclusivo del pool compartido: mientras existe, nadie más puede ejecutar
+    // rondas en el pool ni reemplazarlo. Si está vacío, el llamador va en serie
+    class UsoPool {
+    private:
+        PoolHilos* p = nullptr;
+
+    public:
+        UsoPool() = default;
+        explicit UsoPool(PoolHilos* pool) : p(pool) {}
+        UsoPool(UsoPool&& otro) noexcept : p(exchange(otro.p, nullptr)) {}
+        UsoPool(const UsoPool&) = delete;
+        UsoPool& operator=(const UsoPool&) = delete;
+        ~UsoPool() {
+            if (p)
+                poolOcupado.store(false, memory_order_release);
+        }
+        explicit operator bool() const { return p != nullptr; }
+        PoolHilos* operator->() const { return p; }
+        PoolHilos* get() const { return p; }
+    };
+
+    // Reserva el pool para una matriz de tamaño n. Queda vacío si conviene ir en
+    // serie o si el pool ya está en uso (otro hilo de la aplicación, o una tarea
+    // que corre dentro del propio pool): así las llamadas concurrentes a
+    // multiplicar() no mezclan sus rondas y el pool solo se recrea con otro
+    // número de hilos cuando nadie lo está usando
+    static UsoPool poolPara(int n) {
+        int h = hilos;
+        if (h <= 1 || n < umbralParalelo)
+            return UsoPool();
+        bool libre = false;
+        if (!poolOcupado.compare_exchange_strong(libre, true, memory_order_acquire))
+            return UsoPool();
+        if (!pool || pool->tamano() != h)
+            pool.reset(new PoolHilos(h));
+        return UsoPool(pool.get());
+    }
+
+    // Escribe en datos el valor de la expresión e elemento a elemento.
+    // Sin transposiciones se recorre por filas; con ellas, por bloques TB x TB
+    // para que tanto las lecturas normales como las transpuestas aprovechen la caché.
+    template <class E>
+    void evaluar(const E& e) {
+        auto franja = [&](int t, int) {
+            int i0 = t * FT, i1 = min(n, i0 + FT);
+            if (!E::contieneTranspuesta) {
+                for (int i = i0; i < i1; ++i)
+                    for (int j = 0; j < n; ++j)
+                        datos[i * n + j] = e(i, j);
+                return;
+            }
+            for (int ib = i0; ib < i1; ib += TB)
+                for (int jb = 0; jb < n; jb += TB)
+                    for (int i = ib; i < min(i1, ib + TB); ++i)
+                        for (int j = jb; j < min(n, jb + TB); ++j)
+                            datos[i * n + j] = e(i, j);
+        };
+        int franjas = (n + FT - 1) / FT;
+        if (auto p = poolPara(n))
+            p->ejecutar(franjas, franja);
+        else
+            for (int t = 0; t < franjas; ++t)
+                franja(t, 0);
+    }
+
+    // Operando de la GEMM: puntero y saltos de fila y columna. Las matrices y sus
+    // transpuestas se leen en su sitio; cualquier otra expresión se evalúa antes.
+    struct OperandoGemm;
+
+    template <class X>
+    static OperandoGemm operandoGemm(const X& x);
+
+    // Aplica f(inicio, longitud) sobre tramos del buffer de n * n elementos,
+    // repartidos entre hilos cuando la matriz supera el umbral paralelo
+    template <class F>
+    void porTramos(F f) const {
+        const size_t TRAMO = 1 << 14;
+        size_t total = size_t(n) * n;
+        int tramos = int((total + TRAMO - 1) / TRAMO);
+        auto tarea = [&](int t, int) {
+            size_t inicio = size_t(t) * TRAMO;
+            f(inicio, min(TRAMO, total - inicio));
+        };
+        if (auto p = poolPara(n))
+            p->ejecutar(tramos, tarea);
+        else
+            for (int t = 0; t < tramos; ++t)
+                tarea(t, 0);
+    }
+
+    // Reserva un buffer alineado a línea de caché (64 bytes)
+    static double* reservar(size_t cantidad) {
+        return static_cast<double*>(::operator new[](cantidad * sizeof(double), align_val_t(64)));
+    }
+
+    static void liberar(double* p) {
+        ::operator delete[](p, align_val_t(64));
+    }
+
+    // Copia un bloque mc x kc de A en micro-paneles de MR filas, rellenando con ceros
+    // las filas que sobran en el borde. (rsA, csA) son los saltos entre filas y columnas.
+    static void empaquetarA(int mc, int kc, const double* A, int rsA, int csA, double* destino) {
+        for (int ir = 0; ir < mc; ir += MR) {
+            int filas = min(MR, mc - ir);
+            for (int p = 0; p < kc; ++p) {
+                for (int i = 0; i < filas; ++i)
+                    destino[i] = A[(ir + i) * rsA + p * csA];
+                for (int i = filas; i < MR; ++i)
+                    destino[i] = 0.0;
+                destino += MR;
+            }
+        }
+    }
+
+    // Copia un bloque kc x nc de B en micro-paneles de NR columnas, rellenando con ceros
+    static void empaquetarB(int kc, int nc, const double* B, int rsB, int csB, double* destino) {
+        for (int jr = 0; jr < nc; jr += NR) {
+            int columnas = min(NR, nc - jr);
+            for (int p = 0; p < kc; ++p) {
+                for (int j = 0; j < columnas; ++j)
+                    destino[j] = B[p * rsB + (jr + j) * csB];
+                for (int j = columnas; j < NR; ++j)
+                    destino[j] = 0.0;
+                destino += NR;
+            }
+        }
+    }
+
+    // Producto por bloques C[m x n] += A[m x k] * B[k x n], con empaquetado de paneles.
+    // A y B se leen con saltos arbitrarios, C es contigua por filas con paso ldc.
+    // Con un pool, los bloques MC de filas de C se reparten entre hilos; cada celda
+    // acumula sus productos en el mismo orden que en serie, así que el resultado
+    // es idéntico bit a bit.
+    static void gemm(int m, int n, int k,
+                     const double* A, int rsA, int csA,
+                     const double* B, int rsB, int csB,
+                     double* C, int ldc, PoolHilos* pool = nullptr) {
+        if (m == 0 || n == 0 || k == 0)
+            return;
+        auto micro = NucleosMatriz::tabla().micro;
+        int nh = pool ? pool->tamano() : 1;
+        double* bufA = reservar(size_t(MC) * KC * nh);  // Un bloque de A por hilo
+        double* bufB = reservar(size_t(KC) * (min(NC, n) + NR));
+        for (int jc = 0; jc < n; jc += NC) {
+            int nc = min(NC, n - jc);
+            for (int pc = 0; pc < k; pc += KC) {
+                int kc = min(KC, k - pc);
+                const double* Bpc = B + pc * rsB + jc * csB;
+                int panelesB = (nc + NR - 1) / NR;
+                int bloquesC = (m + MC - 1) / MC;
+
+                // Empaqueta B por grupos de micro-paneles independientes
+                auto empaquetar = [&](int t, int) {
+                    int jr = t * NR * 8;
+                    empaquetarB(kc, min(NR * 8, nc - jr), Bpc + jr * csB, rsB, csB, bufB + jr * kc);
+                };
+                // Cada tarea calcula un bloque MC x nc de C
+                auto calcular = [&](int t, int h) {
+                    int ic = t * MC;
+                    int mc = min(MC, m - ic);
+                    double* bloqueA = bufA + size_t(h) * MC * KC;
+                    empaquetarA(mc, kc, A + ic * rsA + pc * csA, rsA, csA, bloqueA);
+                    for (int jr = 0; jr < nc; jr += NR) {
+                        for (int ir = 0; ir < mc; ir += MR) {
+                            micro(kc, bloqueA + ir * kc, bufB + jr * kc,
+                                  C + (ic + ir) * ldc + jc + jr, ldc,
+                                  min(MR, mc - ir), min(NR, nc - jr));
+                        }
+                    }
+                };
+
+                if (pool) {
+                    pool->ejecutar((panelesB + 7) / 8, empaquetar);
+                    pool->ejecutar(bloquesC, calcular);
+                } else {
+                    empaquetarB(kc, nc, Bpc, rsB, csB, bufB);
+                    for (int t = 0; t < bloquesC; ++t)
+                        calcular(t, 0);
+                }
+            }
+        }
+        liberar(bufA);
+        liberar(bufB);
+    }
+
+    // R = P + Q o R = P - Q sobre bloques h x h con pasos de fila arbitrarios
+    static void sumaBloque(int h, const double* P, int ldp, const double* Q, int ldq,
+                           double* R, int ldr, bool restar = false) {
+        const NucleosMatriz::Tabla& nu = NucleosMatriz::tabla();
+        for (int i = 0; i < h; ++i) {
+            if (restar)
+                nu.resta(P + i * ldp, Q + i * ldq, R + i * ldr, h);
+            else
+                nu.suma(P + i * ldp, Q + i * ldq, R + i * ldr, h);
+        }
+    }
+
+    // C[n x n] = A * B con la variante de Winograd del algoritmo de Strassen
+    // (7 productos y 15 sumas por nivel). Por debajo de 'corte' se usa la GEMM por
+    // bloques. Un n impar se resuelve pelando la última fila y columna: la parte
+    // par se hace de forma recursiva y el borde se corrige con productos de rango 1.
+    // Usa tres temporales de (n/2)^2 por nivel, unas n^2 posiciones en total.
+    static void strassen(int n, const double* A, int lda, const double* B, int ldb,
+                         double* C, int ldc, int corte) {
+        if (n <= corte || n < 2) {
+            for (int i = 0; i < n; ++i)
+                fill(C + i * ldc, C + i * ldc + n, 0.0);
+            gemm(n, n, n, A, lda, 1, B, ldb, 1, C, ldc, poolPara(n).get());
+            return;
+        }
+        if (n % 2) {
+            int m = n - 1;
+            strassen(m, A, lda, B, ldb, C, ldc, corte);
+            gemm(m, m, 1, A + m, lda, 1, B + m * ldb, ldb, 1, C, ldc, poolPara(m).get());
+            for (int i = 0; i < m; ++i)
+                C[i * ldc + m] = 0.0;
+            fill(C + m * ldc, C + m * ldc + n, 0.0);
+            gemm(m, 1, n, A, lda, 1, B + m, ldb, 1, C + m, ldc);
+            gemm(1, n, n, A + m * lda, lda, 1, B, ldb, 1, C + m * ldc, ldc);
+            return;
+        }
+        int h = n / 2;
+        const double *A11 = A, *A12 = A + h, *A21 = A + h * lda, *A22 = A21 + h;
+        const double *B11 = B, *B12 = B + h, *B21 = B + h * ldb, *B22 = B21 + h;
+        double *C11 = C, *C12 = C + h, *C21 = C + h * ldc, *C22 = C21 + h;
+        double* X = reservar(size_t(3) * h * h);
+        double* Y = X + size_t(h) * h;
+        double* Z = Y + size_t(h) * h;
+
+        sumaBloque(h, A11, lda, A21, lda, X, h, true);          // S3 = A11 - A21
+        sumaBloque(h, B22, ldb, B12, ldb, Y, h, true);          // T3 = B22 - B12
+        strassen(h, X, h, Y, h, C21, ldc, corte);               // M7 = S3 * T3
+        sumaBloque(h, A21, lda, A22, lda, X, h);                // S1 = A21 + A22
+        sumaBloque(h, B12, ldb, B11, ldb, Y, h, true);          // T1 = B12 - B11
+        strassen(h, X, h, Y, h, C22, ldc, corte);               // M5 = S1 * T1
+        sumaBloque(h, X, h, A11, lda, X, h, true);              // S2 = S1 - A11
+        sumaBloque(h, B22, ldb, Y, h, Y, h, true);              // T2 = B22 - T1
+        strassen(h, X, h, Y, h, C12, ldc, corte);               // M6 = S2 * T2
+        sumaBloque(h, A12, lda, X, h, X, h, true);              // S4 = A12 - S2
+        strassen(h, X, h, B22, ldb, C11, ldc, corte);           // M3 = S4 * B22
+        strassen(h, A11, lda, B11, ldb, Z, h, corte);           // M1 = A11 * B11
+        sumaBloque(h, C12, ldc, Z, h, C12, ldc);                // U2 = M1 + M6
+        sumaBloque(h, C21, ldc, C12, ldc, C21, ldc);            // U3 = U2 + M7
+        sumaBloque(h, C12, ldc, C22, ldc, C12, ldc);            // U4 = U2 + M5
+        sumaBloque(h, C21, ldc, C22, ldc, C22, ldc);            // C22 = U3 + M5
+        sumaBloque(h, C12, ldc, C11, ldc, C12, ldc);            // C12 = U4 + M3
+        sumaBloque(h, Y, h, B21, ldb, Y, h, true);              // T4 = T2 - B21
+        strassen(h, A22, lda, Y, h, C11, ldc, corte);           // M4 = A22 * T4
+        sumaBloque(h, C21, ldc, C11, ldc, C21, ldc, true);      // C21 = U3 - M4
+        strassen(h, A12, lda, B21, ldb, C11, ldc, corte);       // M2 = A12 * B21
+        sumaBloque(h, C11, ldc, Z, h, C11, ldc);                // C11 = M1 + M2
+        liberar(X);
+    }
+
+    // Libera el buffer propio o deshace el mapeo del archivo
+    void soltar() {
+#ifdef MATRIZ_MMAP
+        if (mapeo) {
+            munmap(mapeo, bytesMapeados);
+            mapeo = nullptr;
+            return;
+        }
+#endif
+        liberar(datos);
+    }
+
+    void intercambiar(Matriz& otra) noexcept {
+        swap(n, otra.n);
+        swap(datos, otra.datos);
+        swap(mapeo, otra.mapeo);
+        swap(bytesMapeados, otra.bytesMapeados);
+    }
+
+    // Constructor sin inicializar: solo reserva, para matrices que se sobrescriben enteras.
+    // Desde fuera se usa a través de sinInicializar().
+    struct SinInicializar {};
+    Matriz(int tam, SinInicializar) : n(tam) {
+        datos = reservar(size_t(n) * n);
+    }
+
+    // Transposición recursiva (cache-oblivious) de dst[i0..i1) x [j0..j1) = src^T.
+    // Divide la dimensión mayor en múltiplos de TB hasta llegar a hojas TB x TB,
+    // que se resuelven con el núcleo vectorial de bloques.
+    static void transponerRec(const double* src, double* dst, int n,
+                              int i0, int i1, int j0, int j1, const NucleosMatriz::Tabla& nu) {
+        int di = i1 - i0, dj = j1 - j0;
+        if (di <= TB && dj <= TB) {
+            if (di == TB && dj == TB) {
+                for (int i = i0; i < i1; i += nu.ladoT)
+                    for (int j = j0; j < j1; j += nu.ladoT)
+                        nu.transponerBloque(src + j * n + i, n, dst + i * n + j, n);
+            } else {
+                for (int i = i0; i < i1; ++i)
+                    for (int j = j0; j < j1; ++j)
+                        dst[i * n + j] = src[j * n + i];
+            }
+            return;
+        }
+        if (di >= dj) {
+            int im = i0 + (di / TB + 1) / 2 * TB;
+            transponerRec(src, dst, n, i0, im, j0, j1, nu);
+            transponerRec(src, dst, n, im, i1, j0, j1, nu);
+        } else {
+            int jm = j0 + (dj / TB + 1) / 2 * TB;
+            transponerRec(src, dst, n, i0, i1, j0, jm, nu);
+            transponerRec(src, dst, n, i0, i1, jm, j1, nu);
+        }
+    }
 
 public:
     // Constructor: inicializa la matriz con valores aleatorios
     Matriz(int tam) : n(tam) {
         srand(time(nullptr)); // Inicializa la semilla aleatoria una vez
-        datos = new double*[n];
-        for (int i = 0; i < n; ++i) {
-            datos[i] = new double[n];
-            for (int j = 0; j < n; ++j) {
-                datos[i][j] = rand() % 10; // Valores aleatorios entre 0 y 9
-            }
+        datos = reservar(size_t(n) * n);
+        for (size_t i = 0; i < size_t(n) * n; ++i) {
+            datos[i] = rand() % 10; // Valores aleatorios entre 0 y 9
         }
     }
 
+    // Constructor que copia los valores de un buffer existente (n * n elementos por filas)
+    Matriz(int tam, const double* valores) : n(tam) {
+        datos = reservar(size_t(n) * n);
+        copy(valores, valores + size_t(n) * n, datos);
+    }
+
+#ifdef MATRIZ_PRUEBAS
+    // Copias completas del buffer hechas por el constructor y la asignación de copia;
+    // las pruebas lo usan para comprobar que las expresiones encadenadas no copian
+    inline static atomic<long> copiasProfundas{0};
+#endif
+
     // Constructor de copia (para evitar problemas con memoria dinámica)
     Matriz(const Matriz& otra) : n(otra.n) {
-        datos = new double*[n];
-        for (int i = 0; i < n; ++i) {
-            datos[i] = new double[n];
-            for (int j = 0; j < n; ++j) {
-                datos[i][j] = otra.datos[i][j];
-            }
+        datos = reservar(size_t(n) * n);
+        copy(otra.datos, otra.datos + size_t(n) * n, datos);
+#ifdef MATRIZ_PRUEBAS
+        ++copiasProfundas;
+#endif
+    }
+
+    // Constructor de movimiento: toma el buffer de la otra matriz sin copiarlo
+    Matriz(Matriz&& otra) noexcept
+        : n(otra.n), datos(otra.datos), mapeo(otra.mapeo), bytesMapeados(otra.bytesMapeados) {
+        otra.n = 0;
+        otra.datos = nullptr;
+        otra.mapeo = nullptr;
+    }
+
+    // Asignación por copia; reutiliza el buffer si el tamaño coincide
+    Matriz& operator=(const Matriz& otra) {
+        if (this == &otra)
+            return *this;
+        if (n != otra.n) {
+            double* nuevos = reservar(size_t(otra.n) * otra.n);
+            soltar();
+            datos = nuevos;
+            n = otra.n;
         }
+        copy(otra.datos, otra.datos + size_t(n) * n, datos);
+#ifdef MATRIZ_PRUEBAS
+        ++copiasProfundas;
+#endif
+        return *this;
+    }
+
+    // Asignación por movimiento: intercambia los buffers
+    Matriz& operator=(Matriz&& otra) noexcept {
+        intercambiar(otra);
+        return *this;
+    }
+
+    // Matriz con memoria reservada pero sin inicializar
+    static Matriz sinInicializar(int tam) {
+        return Matriz(tam, SinInicializar{});
     }
 
-    // Método para calcular la transpuesta de la matriz
+    // Matriz llena de ceros
+    static Matriz ceros(int tam) {
+        Matriz M(tam, SinInicializar{});
+        fill(M.datos, M.datos + size_t(tam) * tam, 0.0);
+        return M;
+    }
+
+    // Matriz identidad
+    static Matriz identidad(int tam) {
+        Matriz M = ceros(tam);
+        for (int i = 0; i < tam; ++i)
+            M.datos[i * tam + i] = 1.0;
+        return M;
+    }
+
+    int tamano() const {
+        return n;
+    }
+
+    // Número de hilos usados por multiplicar() y transpuesta(); 1 desactiva el modo paralelo
+    static void establecerHilos(int cantidad) {
+        hilos = max(1, cantidad);
+    }
+
+    static int obtenerHilos() {
+        return hilos;
+    }
+
+    // Tamaño mínimo de matriz a partir del cual se usan los hilos
+    static void establecerUmbralParalelo(int tam) {
+        umbralParalelo = tam;
+    }
+
+    // Activa el modo Strassen-Winograd en multiplicar() para n > corte; 0 lo desactiva.
+    // Las hojas de la recursión (n <= corte) usan la GEMM clásica por bloques.
+    //
+    // Cota de error: el producto clásico cumple, elemento a elemento,
+    // |C - C'| <= n u |A| |B| (u = 2^-53). Strassen-Winograd solo admite una cota
+    // en norma, ||C - C'|| <= [(n/n0)^log2(18) (n0^2 + 6 n0)] u ||A|| ||B|| + O(u^2),
+    // con n0 el tamaño de las hojas: cada nivel de recursión multiplica el error
+    // posible por hasta 18/2^2 = 4.5 y las entradas pequeñas de C pueden perder
+    // precisión relativa. Con pocos niveles (n / corte <= 8) el error observado
+    // queda dentro de un orden de magnitud del clásico.
+    static void establecerStrassen(int corte) {
+        corteStrassen.store(max(0, corte), memory_order_relaxed);
+    }
+
+    // Método para calcular la transpuesta de la matriz.
+    // No rellena el resultado antes de escribirlo; en modo paralelo cada hilo toma
+    // franjas de FT filas de T y las transpone de forma recursiva.
     Matriz transpuesta() const {
-        Matriz T(n);
-        for (int i = 0; i < n; ++i) {
-            for (int j = 0; j < n; ++j) {
-                T.datos[i][j] = datos[j][i];
-            }
-        }
+        Matriz T(n, SinInicializar{});
+        const NucleosMatriz::Tabla& nu = NucleosMatriz::tabla();
+        auto franja = [&](int t, int) {
+            transponerRec(datos, T.datos, n, t * FT, min(n, (t + 1) * FT), 0, n, nu);
+        };
+        int franjas = (n + FT - 1) / FT;
+        if (auto p = poolPara(n))
+            p->ejecutar(franjas, franja);
+        else
+            for (int t = 0; t < franjas; ++t)
+                franja(t, 0);
         return T;
     }
 
-    // Método para multiplicar la matriz por otra matriz del mismo tamaño
-    Matriz multiplicar(const Matriz& B) const {
-        Matriz resultado(n);
-        for (int i = 0; i < n; ++i) {
-            for (int j = 0; j < n; ++j) {
-                resultado.datos[i][j] = 0;
-                for (int k = 0; k < n; ++k) {
-                    resultado.datos[i][j] += datos[i][k] * B.datos[k][j];
+    // Transpone la matriz en su propio buffer, sin memoria adicional.
+    // Intercambia pares de bloques L x L simétricos a través de un bloque temporal;
+    // cada tarea paralela se encarga de una fila de bloques TB desde la diagonal.
+    void transponer() {
+        const NucleosMatriz::Tabla& nu = NucleosMatriz::tabla();
+        const int L = nu.ladoT;
+        int completa = n / L * L;  // Parte cubierta por bloques L x L
+        auto filaBloques = [&](int t, int) {
+            double tmp[8 * 8];
+            int I0 = t * TB, I1 = min(completa, I0 + TB);
+            for (int J0 = I0; J0 < completa; J0 += TB) {
+                int J1 = min(completa, J0 + TB);
+                for (int i = I0; i < I1; i += L) {
+                    for (int j = (J0 == I0 ? i : J0); j < J1; j += L) {
+                        double* a = datos + i * n + j;  // Bloque (i, j)
+                        double* b = datos + j * n + i;  // Bloque simétrico (j, i)
+                        nu.transponerBloque(b, n, tmp, L);
+                        if (a != b)
+                            nu.transponerBloque(a, n, b, n);
+                        for (int r = 0; r < L; ++r)
+                            copy(tmp + r * L, tmp + (r + 1) * L, a + r * n);
+                    }
                 }
             }
+        };
+        int tareas = (completa + TB - 1) / TB;
+        if (auto p = poolPara(n))
+            p->ejecutar(tareas, filaBloques);
+        else
+            for (int t = 0; t < tareas; ++t)
+                filaBloques(t, 0);
+        // Filas y columnas finales que no completan un bloque
+        for (int i = completa; i < n; ++i)
+            for (int j = 0; j < i; ++j)
+                swap(datos[i * n + j], datos[j * n + i]);
+    }
+
+    // Vista perezosa de la transpuesta: no copia nada, solo intercambia los saltos
+    // de fila y columna con los que se leen los datos de la matriz original.
+    // La matriz original debe seguir viva mientras se use la vista.
+    class VistaTranspuesta {
+    private:
+        friend class Matriz;
+        const Matriz& m;
+
+    public:
+        explicit VistaTranspuesta(const Matriz& original) : m(original) {}
+
+        int tamano() const {
+            return m.n;
         }
+
+        double operator()(int i, int j) const {
+            return m.datos[j * m.n + i];
+        }
+
+        // Producto A^T * B sin materializar A^T
+        Matriz multiplicar(const Matriz& B) const {
+            int n = m.n;
+            Matriz resultado = ceros(n);
+            gemm(n, n, n, m.datos, 1, n, B.datos, n, 1, resultado.datos, n, poolPara(n).get());
+            return resultado;
+        }
+
+        // Vuelve a convertir la vista en una matriz independiente
+        Matriz materializar() const {
+            return m.transpuesta();
+        }
+    };
+
+    VistaTranspuesta vistaTranspuesta() const {
+        return VistaTranspuesta(*this);
+    }
+
+    // Método para multiplicar la matriz por otra matriz del mismo tamaño.
+    // Usa el núcleo por bloques con empaquetado, que recorre A y B de forma contigua.
+    Matriz multiplicar(const Matriz& B) const {
+        // Solo importa el valor del corte, no ordena otras memorias: basta relaxed
+        int corte = corteStrassen.load(memory_order_relaxed);
+        if (corte > 0 && n > corte)
+            return multiplicarStrassen(B, corte);
+        Matriz resultado = ceros(n);
+        gemm(n, n, n, datos, n, 1, B.datos, n, 1, resultado.datos, n, poolPara(n).get());
+        return resultado;
+    }
+
+    // Multiplicación con Strassen-Winograd y el corte indicado, sin depender de
+    // la configuración global (ver establecerStrassen() para la cota de error)
+    Matriz multiplicarStrassen(const Matriz& B, int corte) const {
+        Matriz resultado(n, SinInicializar{});
+        strassen(n, datos, n, B.datos, n, resultado.datos, n, max(corte, 1));
+        return resultado;
+    }
+
+    // Producto A * B^T leyendo B con los saltos intercambiados, sin transponerla
+    Matriz multiplicar(const VistaTranspuesta& Bt) const {
+        Matriz resultado = ceros(n);
+        const Matriz& B = Bt.m;
+        gemm(n, n, n, datos, n, 1, B.datos, 1, n, resultado.datos, n, poolPara(n).get());
+        return resultado;
+    }
+
+    // Suma elemento a elemento con otra matriz del mismo tamaño
+    Matriz sumar(const Matriz& B) const {
+        Matriz resultado(n, SinInicializar{});
+        auto suma = NucleosMatriz::tabla().suma;
+        porTramos([&](size_t i, size_t len) { suma(datos + i, B.datos + i, resultado.datos + i, len); });
         return resultado;
     }
 
+    // Resta elemento a elemento con otra matriz del mismo tamaño
+    Matriz restar(const Matriz& B) const {
+        Matriz resultado(n, SinInicializar{});
+        auto resta = NucleosMatriz::tabla().resta;
+        porTramos([&](size_t i, size_t len) { resta(datos + i, B.datos + i, resultado.datos + i, len); });
+        return resultado;
+    }
+
+    // Multiplica todos los elementos por un escalar
+    Matriz escalar(double k) const {
+        Matriz resultado(n, SinInicializar{});
+        auto escala = NucleosMatriz::tabla().escala;
+        porTramos([&](size_t i, size_t len) { escala(datos + i, k, resultado.datos + i, len); });
+        return resultado;
+    }
+
+    // ---------------------- Plantillas de expresiones ----------------------
+
+    // Una matriz es una hoja de expresión sin transposiciones
+    static constexpr bool contieneTranspuesta = false;
+
+    // Construye la matriz evaluando una expresión en una sola pasada
+    template <class E>
+    Matriz(const ExprMatriz<E>& e) : n(e.derivada().tamano()) {
+        datos = reservar(size_t(n) * n);
+        evaluar(e.derivada());
+    }
+
+    // Asigna una expresión. Si la expresión lee elementos transpuestos podría leer
+    // celdas ya sobrescritas de esta misma matriz, así que se evalúa en un temporal.
+    template <class E>
+    Matriz& operator=(const ExprMatriz<E>& e) {
+        if (E::contieneTranspuesta || n != e.derivada().tamano()) {
+            Matriz tmp(e);
+            intercambiar(tmp);
+        } else {
+            evaluar(e.derivada());
+        }
+        return *this;
+    }
+
+    // Transpuesta perezosa para usar dentro de expresiones
+    TranspuestaExpr<const Matriz&> T() const&;
+    TranspuestaExpr<Matriz> T() &&;
+
+    // Producto matricial de dos expresiones; ver operator* más abajo
+    template <class L, class R>
+    static Matriz producto(const L& a, const R& b);
+
     // Sobrecarga del operador () para acceso a elementos (lectura y escritura)
     double& operator()(int i, int j) {
-        return datos[i][j];
+        return datos[i * n + j];
     }
 
     // Versión const del operador de acceso
     const double& operator()(int i, int j) const {
-        return datos[i][j];
+        return datos[i * n + j];
+    }
+
+    // ------------------------- Formato binario -------------------------
+    //
+    // Archivo = cabecera de 64 bytes + n * n doubles por filas, en el orden de bytes
+    // de la máquina. Los datos empiezan en el byte 64, así que quedan alineados
+    // a línea de caché cuando el archivo se mapea en memoria.
+    struct Cabecera {
+        char magia[8];          // "MATRIZ\0\0"
+        uint32_t version;       // 1
+        uint32_t tipoDato;      // 1 = double de 64 bits
+        uint32_t disposicion;   // 0 = por filas
+        uint32_t reservado;
+        uint64_t filas;
+        uint64_t columnas;
+        char relleno[24];
+    };
+    static_assert(sizeof(Cabecera) == 64, "la cabecera debe ocupar 64 bytes");
+
+    static Cabecera cabeceraPara(int tam) {
+        Cabecera c{};
+        memcpy(c.magia, "MATRIZ", 6);
+        c.version = 1;
+        c.tipoDato = 1;
+        c.disposicion = 0;
+        c.filas = c.columnas = uint64_t(tam);
+        return c;
+    }
+
+    // Comprueba una cabecera leída y devuelve n; lanza runtime_error si no es válida
+    static int validarCabecera(const Cabecera& c, uint64_t bytesArchivo, const string& ruta) {
+        Cabecera esperada = cabeceraPara(0);
+        if (memcmp(c.magia, esperada.magia, 8) != 0 || c.version != 1)
+            throw runtime_error("Matriz: " + ruta + " no tiene formato binario de Matriz");
+        if (c.tipoDato != 1 || c.disposicion != 0 || c.filas != c.columnas)
+            throw runtime_error("Matriz: " + ruta + " usa un tipo o disposición no soportados");
+        if (c.filas > uint64_t(INT_MAX))
+            throw runtime_error("Matriz: " + ruta + " declara un tamaño no soportado");
+        // filas * filas * 8 puede desbordar 64 bits incluso con filas <= INT_MAX, así
+        // que se compara dividiendo por filas en lugar de multiplicar
+        uint64_t valores = bytesArchivo < sizeof(Cabecera) ? 0 : (bytesArchivo - sizeof(Cabecera)) / sizeof(double);
+        if (c.filas != 0 && c.filas > valores / c.filas)
+            throw runtime_error("Matriz: " + ruta + " está truncado");
+        return int(c.filas);
+    }
+
+    // Escritor por flujo: escribe la cabecera al abrir y luego las filas de una en una,
+    // sin necesidad de tener la matriz completa en memoria.
+    class Escritor {
+    private:
+        ofstream salida;
+        int n;
+        int filasEscritas = 0;
+
+    public:
+        Escritor(const string& ruta, int tam) : salida(ruta, ios::binary), n(tam) {
+            if (!salida)
+                throw runtime_error("Matriz: no se puede crear " + ruta);
+            Cabecera c = cabeceraPara(n);
+            salida.write(reinterpret_cast<const char*>(&c), sizeof c);
+        }
+
+        // Escribe 'cantidad' filas consecutivas de n valores
+        void escribirFilas(const double* filas, int cantidad = 1) {
+            salida.write(reinterpret_cast<const char*>(filas), streamsize(sizeof(double)) * n * cantidad);
+            filasEscritas += cantidad;
+        }
+
+        // Cierra el archivo; lanza runtime_error si faltaron filas o falló la escritura
+        void cerrar() {
+            salida.close();
+            if (!salida || filasEscritas != n)
+                throw runtime_error("Matriz: escritura incompleta");
+        }
+    };
+
+    // Guarda la matriz en formato binario
+    void guardar(const string& ruta) const {
+        Escritor e(ruta, n);
+        const int BLOQUE = max(1, (1 << 20) / max(1, n));  // Unas 8 MB por escritura
+        for (int i = 0; i < n; i += BLOQUE)
+            e.escribirFilas(datos + size_t(i) * n, min(BLOQUE, n - i));
+        e.cerrar();
+    }
+
+    // Carga una matriz en formato binario mapeando el archivo en memoria, sin copiar
+    // los datos: las páginas se leen del disco a medida que se usan. El mapeo es
+    // privado (copia en escritura), por lo que modificar la matriz nunca altera el
+    // archivo. En sistemas sin mmap se lee el archivo completo a un buffer propio.
+    static Matriz cargar(const string& ruta) {
+#ifdef MATRIZ_MMAP
+        int fd = open(ruta.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw runtime_error("Matriz: no se puede abrir " + ruta);
+        struct stat info;
+        if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(Cabecera)) {
+            close(fd);
+            throw runtime_error("Matriz: " + ruta + " está truncado");
+        }
+        size_t bytes = size_t(info.st_size);
+        // No es una vista de solo lectura: Matriz da acceso de escritura a sus datos
+        // (operator(), transposición en el sitio, asignaciones), y con PROT_READ esas
+        // escrituras terminarían en un fallo de segmentación. MAP_PRIVATE hace copia
+        // en escritura de las páginas tocadas, así que el archivo nunca cambia y las
+        // páginas solo leídas siguen compartidas con la caché del sistema sin copiarse
+        void* base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED)
+            throw runtime_error("Matriz: no se puede mapear " + ruta);
+        int tam;
+        try {
+            tam = validarCabecera(*static_cast<const Cabecera*>(base), bytes, ruta);
+        } catch (...) {
+            munmap(base, bytes);
+            throw;
+        }
+        madvise(base, bytes, MADV_SEQUENTIAL);
+        Matriz M(0, SinInicializar{});
+        liberar(M.datos);
+        M.n = tam;
+        M.datos = reinterpret_cast<double*>(static_cast<char*>(base) + sizeof(Cabecera));
+        M.mapeo = base;
+        M.bytesMapeados = bytes;
+        return M;
+#else
+        ifstream entrada(ruta, ios::binary | ios::ate);
+        if (!entrada)
+            throw runtime_error("Matriz: no se puede abrir " + ruta);
+        uint64_t bytes = uint64_t(entrada.tellg());
+        Cabecera c{};
+        entrada.seekg(0);
+        entrada.read(reinterpret_cast<char*>(&c), sizeof c);
+        int tam = validarCabecera(c, bytes, ruta);
+        Matriz M(tam, SinInicializar{});
+        entrada.read(reinterpret_cast<char*>(M.datos), streamsize(sizeof(double)) * tam * tam);
+        return M;
+#endif
+    }
+
+    // Indica si los datos viven en un archivo mapeado
+    bool estaMapeada() const {
+        return mapeo != nullptr;
     }
 
     // Método para imprimir la matriz
     void imprimir() const {
         for (int i = 0; i < n; ++i) {
             for (int j = 0; j < n; ++j) {
-                cout << setw(5) << datos[i][j] << " ";
+                cout << setw(5) << datos[i * n + j] << " ";
             }
             cout << endl;
         }
@@ -80,8 +1190,1188 @@ public:
 
     // Destructor: libera la memoria asignada dinámicamente
     ~Matriz() {
+        soltar();
+    }
+};
+
+// ---------------------- Nodos de las expresiones perezosas ----------------------
+
+// Cómo guarda un nodo a sus operandos: las matrices con nombre por referencia,
+// las matrices temporales por valor (movidas) y los demás nodos por valor.
+template <class T> struct AlmacenExpr { using tipo = typename decay<T>::type; };
+template <> struct AlmacenExpr<Matriz&> { using tipo = const Matriz&; };
+template <> struct AlmacenExpr<const Matriz&> { using tipo = const Matriz&; };
+
+template <class T>
+constexpr bool esExprMatriz = is_base_of<ExprMatriz<typename decay<T>::type>, typename decay<T>::type>::value;
+
+template <class E>
+class TranspuestaExpr : public ExprMatriz<TranspuestaExpr<E>> {
+private:
+    E e;
+
+public:
+    using Operando = typename decay<E>::type;
+    static constexpr bool contieneTranspuesta = true;
+
+    template <class X>
+    explicit TranspuestaExpr(X&& x) : e(forward<X>(x)) {}
+
+    int tamano() const { return e.tamano(); }
+    double operator()(int i, int j) const { return e(j, i); }
+    const Operando& operando() const { return e; }
+};
+
+struct OpSuma {
+    static double aplicar(double x, double y) { return x + y; }
+};
+
+struct OpResta {
+    static double aplicar(double x, double y) { return x - y; }
+};
+
+template <class L, class R, class Op>
+class BinariaExpr : public ExprMatriz<BinariaExpr<L, R, Op>> {
+private:
+    L a;
+    R b;
+
+public:
+    static constexpr bool contieneTranspuesta =
+        decay<L>::type::contieneTranspuesta || decay<R>::type::contieneTranspuesta;
+
+    template <class X, class Y>
+    BinariaExpr(X&& x, Y&& y) : a(forward<X>(x)), b(forward<Y>(y)) {}
+
+    int tamano() const { return a.tamano(); }
+    double operator()(int i, int j) const { return Op::aplicar(a(i, j), b(i, j)); }
+};
+
+template <class E>
+class EscalaExpr : public ExprMatriz<EscalaExpr<E>> {
+private:
+    E e;
+    double k;
+
+public:
+    static constexpr bool contieneTranspuesta = decay<E>::type::contieneTranspuesta;
+
+    template <class X>
+    EscalaExpr(X&& x, double factor) : e(forward<X>(x)), k(factor) {}
+
+    int tamano() const { return e.tamano(); }
+    double operator()(int i, int j) const { return e(i, j) * k; }
+};
+
+inline TranspuestaExpr<const Matriz&> Matriz::T() const& {
+    return TranspuestaExpr<const Matriz&>(*this);
+}
+
+inline TranspuestaExpr<Matriz> Matriz::T() && {
+    return TranspuestaExpr<Matriz>(move(*this));
+}
+
+template <class X> struct EsTranspuestaDeMatriz : false_type {};
+template <class E> struct EsTranspuestaDeMatriz<TranspuestaExpr<E>> : is_same<typename decay<E>::type, Matriz> {};
+
+struct Matriz::OperandoGemm {
+    Matriz propio{0, SinInicializar{}};  // Solo se usa si hay que evaluar la expresión
+    const double* p;
+    int rs, cs;
+};
+
+template <class X>
+Matriz::OperandoGemm Matriz::operandoGemm(const X& x) {
+    OperandoGemm o;
+    if constexpr (is_same<X, Matriz>::value) {
+        o.p = x.datos, o.rs = x.n, o.cs = 1;
+    } else if constexpr (EsTranspuestaDeMatriz<X>::value) {
+        const Matriz& m = x.operando();  // Transpuesta de una matriz: saltos intercambiados
+        o.p = m.datos, o.rs = 1, o.cs = m.n;
+    } else {
+        o.propio = Matriz(x);
+        o.p = o.propio.datos, o.rs = o.propio.n, o.cs = 1;
+    }
+    return o;
+}
+
+template <class L, class R>
+Matriz Matriz::producto(const L& a, const R& b) {
+    OperandoGemm A = operandoGemm(a), B = operandoGemm(b);
+    int n = a.tamano();
+    Matriz resultado = ceros(n);
+    gemm(n, n, n, A.p, A.rs, A.cs, B.p, B.rs, B.cs, resultado.datos, n, poolPara(n).get());
+    return resultado;
+}
+
+// Operadores. Solo participan cuando los operandos son expresiones de matriz.
+template <class L, class R, class = enable_if_t<esExprMatriz<L> && esExprMatriz<R>>>
+BinariaExpr<typename AlmacenExpr<L>::tipo, typename AlmacenExpr<R>::tipo, OpSuma> operator+(L&& a, R&& b) {
+    return {forward<L>(a), forward<R>(b)};
+}
+
+template <class L, class R, class = enable_if_t<esExprMatriz<L> && esExprMatriz<R>>>
+BinariaExpr<typename AlmacenExpr<L>::tipo, typename AlmacenExpr<R>::tipo, OpResta> operator-(L&& a, R&& b) {
+    return {forward<L>(a), forward<R>(b)};
+}
+
+template <class E, class = enable_if_t<esExprMatriz<E>>>
+EscalaExpr<typename AlmacenExpr<E>::tipo> operator*(E&& e, double k) {
+    return {forward<E>(e), k};
+}
+
+template <class E, class = enable_if_t<esExprMatriz<E>>>
+EscalaExpr<typename AlmacenExpr<E>::tipo> operator*(double k, E&& e) {
+    return {forward<E>(e), k};
+}
+
+// El producto matricial no se fusiona: se calcula con la GEMM por bloques y su
+// resultado entra como hoja en el resto de la expresión.
+template <class L, class R, class = enable_if_t<esExprMatriz<L> && esExprMatriz<R>>>
+Matriz operator*(const L& a, const R& b) {
+    return Matriz::producto(a, b);
+}
+
+// ---------------------------- Matriz dispersa ----------------------------
+
+// Matriz dispersa n x n en formato CSR (filas comprimidas) o CSC (columnas comprimidas).
+// En CSR, los elementos de la fila i son indices[punteros[i] .. punteros[i+1]) con sus
+// valores; en CSC lo mismo por columnas. Los índices de cada fila/columna quedan
+// ordenados. Las operaciones reparten filas (o columnas) entre los hilos de Matriz.
+class MatrizDispersa {
+public:
+    enum Formato { CSR, CSC };
+
+private:
+    int n;
+    Formato formato;
+    vector<int> punteros;   // n + 1 posiciones de inicio
+    vector<int> indices;    // Columna (CSR) o fila (CSC) de cada elemento no nulo
+    vector<double> valores;
+
+    static constexpr int FILAS_TAREA = 64;  // Filas (o columnas) por tarea paralela
+
+    MatrizDispersa(int tam, Formato f) : n(tam), formato(f), punteros(tam + 1, 0) {}
+
+    // Ejecuta f(inicio, fin, hilo) sobre bloques de FILAS_TAREA filas, en paralelo si conviene
+    template <class F>
+    static void porBloques(int total, F f) {
+        porBloques(total, Matriz::poolPara(total).get(), f);
+    }
+
+    // Igual, con un pool ya reservado por el llamador (o nullptr para ir en serie)
+    template <class F>
+    static void porBloques(int total, PoolHilos* p, F f) {
+        int tareas = (total + FILAS_TAREA - 1) / FILAS_TAREA;
+        auto tarea = [&](int t, int h) {
+            f(t * FILAS_TAREA, min(total, (t + 1) * FILAS_TAREA), h);
+        };
+        if (p)
+            p->ejecutar(tareas, tarea);
+        else
+            for (int t = 0; t < tareas; ++t)
+                tarea(t, 0);
+    }
+
+    // Reorganiza los mismos datos en el formato contrario (ordenamiento por conteo)
+    MatrizDispersa cambiarFormato() const {
+        MatrizDispersa R(n, formato == CSR ? CSC : CSR);
+        size_t nnz = valores.size();
+        R.indices.resize(nnz);
+        R.valores.resize(nnz);
+        for (size_t k = 0; k < nnz; ++k)
+            ++R.punteros[indices[k] + 1];
         for (int i = 0; i < n; ++i)
-            delete[] datos[i];
-        delete[] datos;
+            R.punteros[i + 1] += R.punteros[i];
+        vector<int> siguiente(R.punteros.begin(), R.punteros.end() - 1);
+        for (int i = 0; i < n; ++i) {
+            for (int k = punteros[i]; k < punteros[i + 1]; ++k) {
+                int destino = siguiente[indices[k]]++;
+                R.indices[destino] = i;
+                R.valores[destino] = valores[k];
+            }
+        }
+        return R;
+    }
+
+public:
+    // Convierte una matriz densa, descartando los valores con |x| <= tolerancia
+    explicit MatrizDispersa(const Matriz& M, double tolerancia = 0.0, Formato f = CSR)
+        : n(M.n), formato(f), punteros(M.n + 1, 0) {
+        const double* d = M.datos;
+        int tam = n;
+        // El elemento k-ésimo de la línea i (fila en CSR, columna en CSC)
+        auto elemento = [&](int i, int k) { return f == CSR ? d[i * tam + k] : d[k * tam + i]; };
+        // Primera pasada: cuenta los no nulos de cada línea
+        porBloques(n, [&](int i0, int i1, int) {
+            for (int i = i0; i < i1; ++i) {
+                int c = 0;
+                for (int k = 0; k < tam; ++k)
+                    c += fabs(elemento(i, k)) > tolerancia;
+                punteros[i + 1] = c;
+            }
+        });
+        for (int i = 0; i < n; ++i)
+            punteros[i + 1] += punteros[i];
+        indices.resize(punteros[n]);
+        valores.resize(punteros[n]);
+        // Segunda pasada: cada línea se escribe en su tramo ya reservado
+        porBloques(n, [&](int i0, int i1, int) {
+            for (int i = i0; i < i1; ++i) {
+                int pos = punteros[i];
+                for (int k = 0; k < tam; ++k) {
+                    double x = elemento(i, k);
+                    if (fabs(x) > tolerancia) {
+                        indices[pos] = k;
+                        valores[pos++] = x;
+                    }
+                }
+            }
+        });
+    }
+
+    int tamano() const {
+        return n;
+    }
+
+    size_t noNulos() const {
+        return valores.size();
+    }
+
+    Formato obtenerFormato() const {
+        return formato;
+    }
+
+    // Devuelve la misma matriz en el formato pedido
+    MatrizDispersa convertir(Formato f) const {
+        return f == formato ? *this : cambiarFormato();
+    }
+
+    // Transpuesta: los arreglos CSR de A son los CSC de A^T, así que basta con
+    // reinterpretarlos. Se mantiene el formato original con convertir() si hace falta.
+    MatrizDispersa transpuesta() const {
+        MatrizDispersa T(*this);
+        T.formato = (formato == CSR ? CSC : CSR);
+        return T;
+    }
+
+    // Convierte a matriz densa
+    Matriz aDensa() const {
+        Matriz M = Matriz::ceros(n);
+        double* d = M.datos;
+        int tam = n;
+        Formato f = formato;
+        porBloques(n, [&](int i0, int i1, int) {
+            for (int i = i0; i < i1; ++i)
+                for (int k = punteros[i]; k < punteros[i + 1]; ++k) {
+                    if (f == CSR)
+                        d[i * tam + indices[k]] = valores[k];
+                    else
+                        d[indices[k] * tam + i] = valores[k];
+                }
+        });
+        return M;
+    }
+
+    // Producto disperso x denso: cada fila de C es una combinación de filas de B
+    Matriz multiplicar(const Matriz& B) const {
+        if (formato == CSC)
+            return cambiarFormato().multiplicar(B);
+        Matriz C = Matriz::ceros(n);
+        double* c = C.datos;
+        const double* b = B.datos;
+        int tam = n;
+        porBloques(n, [&](int i0, int i1, int) {
+            for (int i = i0; i < i1; ++i) {
+                double* ci = c + size_t(i) * tam;
+                for (int k = punteros[i]; k < punteros[i + 1]; ++k) {
+                    const double* bk = b + size_t(indices[k]) * tam;
+                    double a = valores[k];
+                    for (int j = 0; j < tam; ++j)
+                        ci[j] += a * bk[j];
+                }
+            }
+        });
+        return C;
+    }
+
+    // Producto disperso x disperso (algoritmo de Gustavson) con resultado en CSR.
+    // Cada hilo usa un acumulador denso y un arreglo de marcas de n posiciones; una
+    // primera pasada cuenta los no nulos de cada fila para que la segunda escriba
+    // sin sincronización. Las marcas valen i en la primera pasada e i + n en la segunda.
+    MatrizDispersa multiplicar(const MatrizDispersa& B) const {
+        if (formato == CSC)
+            return cambiarFormato().multiplicar(B);
+        if (B.formato == CSC)
+            return multiplicar(B.cambiarFormato());
+        MatrizDispersa C(n, CSR);
+        // Las dos pasadas usan el mismo pool, reservado aquí, y un juego de marcas por hilo
+        auto uso = Matriz::poolPara(n);
+        int nh = uso ? uso->tamano() : 1;
+        vector<vector<int>> marcas(nh, vector<int>(n, -1));
+        vector<vector<double>> acumuladores(nh, vector<double>(n, 0.0));
+        porBloques(n, uso.get(), [&](int i0, int i1, int h) {
+            vector<int>& marca = marcas[h];
+            for (int i = i0; i < i1; ++i) {
+                int c = 0;
+                for (int k = punteros[i]; k < punteros[i + 1]; ++k)
+                    for (int q = B.punteros[indices[k]]; q < B.punteros[indices[k] + 1]; ++q)
+                        if (marca[B.indices[q]] != i) {
+                            marca[B.indices[q]] = i;
+                            ++c;
+                        }
+                C.punteros[i + 1] = c;
+            }
+        });
+        for (int i = 0; i < n; ++i)
+            C.punteros[i + 1] += C.punteros[i];
+        C.indices.resize(C.punteros[n]);
+        C.valores.resize(C.punteros[n]);
+        porBloques(n, uso.get(), [&](int i0, int i1, int h) {
+            vector<int>& marca = marcas[h];
+            vector<double>& acumulador = acumuladores[h];
+            for (int i = i0; i < i1; ++i) {
+                int inicio = C.punteros[i], pos = inicio;
+                for (int k = punteros[i]; k < punteros[i + 1]; ++k) {
+                    double a = valores[k];
+                    for (int q = B.punteros[indices[k]]; q < B.punteros[indices[k] + 1]; ++q) {
+                        int j = B.indices[q];
+                        if (marca[j] != i + n) {
+                            marca[j] = i + n;
+                            C.indices[pos++] = j;
+                        }
+                        acumulador[j] += a * B.valores[q];
+                    }
+                }
+                sort(C.indices.begin() + inicio, C.indices.begin() + pos);
+                for (int k = inicio; k < pos; ++k) {
+                    C.valores[k] = acumulador[C.indices[k]];
+                    acumulador[C.indices[k]] = 0.0;
+                }
+            }
+        });
+        return C;
     }
 };
+
+// ------------------- Matrices genéricas: tipo y forma arbitrarios -------------------
+
+// Matriz filas x columnas de elementos T (float, double, int, ...) en un buffer
+// contiguo por filas y alineado. Complementa a Matriz, que sigue siendo la versión
+// cuadrada de double con núcleos vectoriales a mano: aquí el producto usa bloques
+// de caché con un bucle interno i-k-j que el compilador vectoriza para cualquier T
+// (con float caben el doble de elementos por registro y por línea de caché).
+template <class T>
+class MatrizDinamica {
+private:
+    int filas, columnas;
+    T* datos;
+
+    static constexpr int BF = 64;   // Filas de C por tarea
+    static constexpr int BK = 128;  // Bloque de la dimensión interna
+    static constexpr int BJ = 256;  // Bloque de columnas de B y C
+
+    // Vector genérico (extensión de GCC/Clang) del ancho que permite la compilación:
+    // 16 bytes con SSE2/NEON, 32 con AVX y 64 con AVX-512 (-march=native).
+#if defined(__GNUC__)
+#if defined(__AVX512F__)
+    static constexpr int BYTES_VEC = 64;
+#elif defined(__AVX__)
+    static constexpr int BYTES_VEC = 32;
+#else
+    static constexpr int BYTES_VEC = 16;
+#endif
+    typedef T Vec __attribute__((vector_size(BYTES_VEC)));
+    static constexpr int VL = int(BYTES_VEC / sizeof(T));
+#endif
+
+    // C[i0..i1) x [j0..j1) += A[.., p0..p0+kc) * B[p0..p0+kc), ..] elemento a elemento
+    static void bordeEscalar(const T* a, const T* b, T* c, int k, int nc,
+                             int i0, int i1, int j0, int j1, int p0, int kc) {
+        for (int i = i0; i < i1; ++i)
+            for (int p = p0; p < p0 + kc; ++p) {
+                T aip = a[size_t(i) * k + p];
+                for (int j = j0; j < j1; ++j)
+                    c[size_t(i) * nc + j] += aip * b[size_t(p) * nc + j];
+            }
+    }
+
+#if defined(__GNUC__)
+    // Micro-bloque: C[4 x 2VL] += A[4 x kc] * B[kc x 2VL] con los 8 acumuladores en registros
+    static void microBloque(const T* A, int lda, const T* B, int ldb, T* C, int ldc, int kc) {
+        Vec acc[4][2] = {};
+        for (int p = 0; p < kc; ++p) {
+            Vec b0, b1;
+            memcpy(&b0, B + size_t(p) * ldb, sizeof(Vec));
+            memcpy(&b1, B + size_t(p) * ldb + VL, sizeof(Vec));
+            for (int r = 0; r < 4; ++r) {
+                T arp = A[size_t(r) * lda + p];
+                acc[r][0] += arp * b0;
+                acc[r][1] += arp * b1;
+            }
+        }
+        for (int r = 0; r < 4; ++r) {
+            for (int v = 0; v < 2; ++v) {
+                Vec cr;
+                memcpy(&cr, C + size_t(r) * ldc + v * VL, sizeof(Vec));
+                cr += acc[r][v];
+                memcpy(C + size_t(r) * ldc + v * VL, &cr, sizeof(Vec));
+            }
+        }
+    }
+#else
+    static constexpr int VL = 4;
+
+    static void microBloque(const T* A, int lda, const T* B, int ldb, T* C, int ldc, int kc) {
+        for (int r = 0; r < 4; ++r)
+            for (int p = 0; p < kc; ++p)
+                for (int j = 0; j < 2 * VL; ++j)
+                    C[size_t(r) * ldc + j] += A[size_t(r) * lda + p] * B[size_t(p) * ldb + j];
+    }
+#endif
+
+    static T* reservar(size_t cantidad) {
+        return static_cast<T*>(::operator new[](cantidad * sizeof(T), align_val_t(64)));
+    }
+
+    static void liberar(T* p) {
+        ::operator delete[](p, align_val_t(64));
+    }
+
+    size_t total() const {
+        return size_t(filas) * columnas;
+    }
+
+    // Ejecuta f(i0, i1) sobre bloques de BF filas, usando los hilos de Matriz
+    template <class Fn>
+    static void porFilas(int nf, int tamRef, Fn f) {
+        int tareas = (nf + BF - 1) / BF;
+        auto tarea = [&](int t, int) { f(t * BF, min(nf, (t + 1) * BF)); };
+        if (auto p = Matriz::poolPara(tamRef))
+            p->ejecutar(tareas, tarea);
+        else
+            for (int t = 0; t < tareas; ++t)
+                tarea(t, 0);
+    }
+
+public:
+    // Constructor: reserva sin inicializar; usar ceros() para una matriz nula
+    MatrizDinamica(int f, int c) : filas(f), columnas(c), datos(reservar(size_t(f) * c)) {}
+
+    // Constructor que copia los valores de un buffer por filas
+    MatrizDinamica(int f, int c, const T* valores) : MatrizDinamica(f, c) {
+        copy(valores, valores + total(), datos);
+    }
+
+    // Conversión de tipo de elemento (p. ej. double -> float)
+    template <class U>
+    explicit MatrizDinamica(const MatrizDinamica<U>& otra) : MatrizDinamica(otra.numFilas(), otra.numColumnas()) {
+        for (int i = 0; i < filas; ++i)
+            for (int j = 0; j < columnas; ++j)
+                datos[size_t(i) * columnas + j] = T(otra(i, j));
+    }
+
+    // Conversión desde la Matriz cuadrada de double
+    explicit MatrizDinamica(const Matriz& M) : MatrizDinamica(M.n, M.n) {
+        for (size_t i = 0; i < total(); ++i)
+            datos[i] = T(M.datos[i]);
+    }
+
+    MatrizDinamica(const MatrizDinamica& otra) : MatrizDinamica(otra.filas, otra.columnas) {
+        copy(otra.datos, otra.datos + total(), datos);
+    }
+
+    MatrizDinamica(MatrizDinamica&& otra) noexcept
+        : filas(otra.filas), columnas(otra.columnas), datos(otra.datos) {
+        otra.filas = otra.columnas = 0;
+        otra.datos = nullptr;
+    }
+
+    MatrizDinamica& operator=(MatrizDinamica otra) noexcept {
+        swap(filas, otra.filas);
+        swap(columnas, otra.columnas);
+        swap(datos, otra.datos);
+        return *this;
+    }
+
+    static MatrizDinamica ceros(int f, int c) {
+        MatrizDinamica M(f, c);
+        fill(M.datos, M.datos + M.total(), T(0));
+        return M;
+    }
+
+    static MatrizDinamica identidad(int tam) {
+        MatrizDinamica M = ceros(tam, tam);
+        for (int i = 0; i < tam; ++i)
+            M(i, i) = T(1);
+        return M;
+    }
+
+    int numFilas() const { return filas; }
+    int numColumnas() const { return columnas; }
+
+    T& operator()(int i, int j) {
+        return datos[size_t(i) * columnas + j];
+    }
+
+    const T& operator()(int i, int j) const {
+        return datos[size_t(i) * columnas + j];
+    }
+
+    // Transpuesta por bloques de 32 x 32
+    MatrizDinamica transpuesta() const {
+        MatrizDinamica R(columnas, filas);
+        for (int i0 = 0; i0 < filas; i0 += 32)
+            for (int j0 = 0; j0 < columnas; j0 += 32)
+                for (int i = i0; i < min(filas, i0 + 32); ++i)
+                    for (int j = j0; j < min(columnas, j0 + 32); ++j)
+                        R.datos[size_t(j) * filas + i] = datos[size_t(i) * columnas + j];
+        return R;
+    }
+
+    // Producto (filas x k) * (k x columnas). Cada tarea calcula un bloque de filas de C;
+    // la dimensión interna y las columnas se recorren por bloques BK x BJ para que el
+    // trozo de B reutilizado por todas las filas de la tarea siga en caché. Dentro del
+    // bloque, microBloque() acumula 4 filas x 2 vectores de C en registros.
+    MatrizDinamica multiplicar(const MatrizDinamica& B) const {
+        int m = filas, k = columnas, nc = B.columnas;
+        MatrizDinamica C = ceros(m, nc);
+        const T* a = datos;
+        const T* b = B.datos;
+        T* c = C.datos;
+        porFilas(m, max(m, nc), [&](int i0, int i1) {
+            for (int p0 = 0; p0 < k; p0 += BK) {
+                int kc = min(BK, k - p0);
+                for (int j0 = 0; j0 < nc; j0 += BJ) {
+                    int j1 = min(nc, j0 + BJ);
+                    int i = i0;
+                    for (; i + 4 <= i1; i += 4) {
+                        int j = j0;
+                        for (; j + 2 * VL <= j1; j += 2 * VL)
+                            microBloque(a + size_t(i) * k + p0, k, b + size_t(p0) * nc + j, nc,
+                                        c + size_t(i) * nc + j, nc, kc);
+                        bordeEscalar(a, b, c, k, nc, i, i + 4, j, j1, p0, kc);
+                    }
+                    bordeEscalar(a, b, c, k, nc, i, i1, j0, j1, p0, kc);
+                }
+            }
+        });
+        return C;
+    }
+
+    MatrizDinamica sumar(const MatrizDinamica& B) const {
+        MatrizDinamica R(filas, columnas);
+        for (size_t i = 0; i < total(); ++i)
+            R.datos[i] = datos[i] + B.datos[i];
+        return R;
+    }
+
+    MatrizDinamica restar(const MatrizDinamica& B) const {
+        MatrizDinamica R(filas, columnas);
+        for (size_t i = 0; i < total(); ++i)
+            R.datos[i] = datos[i] - B.datos[i];
+        return R;
+    }
+
+    MatrizDinamica escalar(T k) const {
+        MatrizDinamica R(filas, columnas);
+        for (size_t i = 0; i < total(); ++i)
+            R.datos[i] = datos[i] * k;
+        return R;
+    }
+
+    void imprimir() const {
+        for (int i = 0; i < filas; ++i) {
+            for (int j = 0; j < columnas; ++j)
+                cout << setw(5) << (*this)(i, j) << " ";
+            cout << endl;
+        }
+    }
+
+    ~MatrizDinamica() {
+        liberar(datos);
+    }
+};
+
+// Matriz de tamaño fijo F x C que vive entera en la pila (o dentro de otro objeto),
+// sin memoria dinámica. Todas las operaciones son constexpr y se desenrollan por
+// completo en tiempo de compilación mediante expansiones de paquetes sobre
+// index_sequence, así que un producto 4x4 queda como 64 multiplicaciones en línea.
+template <class T, int F, int C>
+class MatrizFija {
+private:
+    array<T, size_t(F) * C> datos{};
+
+    template <class, int, int> friend class MatrizFija;
+
+    // Elemento (i, j) del producto: suma desenrollada sobre la dimensión interna
+    template <int K, size_t... P>
+    static constexpr T productoEscalar(const MatrizFija& A, const MatrizFija<T, C, K>& B,
+                                       size_t i, size_t j, index_sequence<P...>) {
+        return (T(0) + ... + (A.datos[i * C + P] * B.datos[P * K + j]));
+    }
+
+    template <int K, size_t... I>
+    static constexpr MatrizFija<T, F, K> producto(const MatrizFija& A, const MatrizFija<T, C, K>& B,
+                                                   index_sequence<I...>) {
+        MatrizFija<T, F, K> R;
+        ((R.datos[I] = productoEscalar<K>(A, B, I / K, I % K, make_index_sequence<C>())), ...);
+        return R;
+    }
+
+    template <class Op, size_t... I>
+    static constexpr MatrizFija combinar(const MatrizFija& A, const MatrizFija& B, Op op, index_sequence<I...>) {
+        MatrizFija R;
+        ((R.datos[I] = op(A.datos[I], B.datos[I])), ...);
+        return R;
+    }
+
+    template <size_t... I>
+    constexpr MatrizFija<T, C, F> transponer(index_sequence<I...>) const {
+        MatrizFija<T, C, F> R;
+        ((R.datos[I] = datos[(I % F) * C + I / F]), ...);
+        return R;
+    }
+
+    using Indices = make_index_sequence<size_t(F) * C>;
+
+public:
+    constexpr MatrizFija() = default;
+
+    // Construcción desde una lista de valores por filas: MatrizFija<double, 2, 2>{1, 2, 3, 4}.
+    // Solo con valores convertibles a T: así, en una 1 x 1, copiar una matriz no
+    // constante usa el constructor de copia y no toma la matriz como valor
+    template <class... V, class = enable_if_t<sizeof...(V) == size_t(F) * C &&
+                                              conjunction<is_convertible<V, T>...>::value>>
+    constexpr MatrizFija(V... valores) : datos{T(valores)...} {}
+
+    static constexpr MatrizFija identidad() {
+        MatrizFija M;
+        for (int i = 0; i < F && i < C; ++i)
+            M.datos[i * C + i] = T(1);
+        return M;
+    }
+
+    static constexpr int numFilas() { return F; }
+    static constexpr int numColumnas() { return C; }
+
+    constexpr T& operator()(int i, int j) { return datos[i * C + j]; }
+    constexpr const T& operator()(int i, int j) const { return datos[i * C + j]; }
+
+    constexpr MatrizFija<T, C, F> transpuesta() const {
+        return transponer(Indices());
+    }
+
+    template <int K>
+    constexpr MatrizFija<T, F, K> operator*(const MatrizFija<T, C, K>& B) const {
+        return producto<K>(*this, B, make_index_sequence<size_t(F) * K>());
+    }
+
+    constexpr MatrizFija operator+(const MatrizFija& B) const {
+        return combinar(*this, B, [](T x, T y) { return x + y; }, Indices());
+    }
+
+    constexpr MatrizFija operator-(const MatrizFija& B) const {
+        return combinar(*this, B, [](T x, T y) { return x - y; }, Indices());
+    }
+
+    constexpr MatrizFija operator*(T k) const {
+        return combinar(*this, *this, [k](T x, T) { return x * k; }, Indices());
+    }
+
+    constexpr bool operator==(const MatrizFija& B) const {
+        for (size_t i = 0; i < datos.size(); ++i)
+            if (datos[i] != B.datos[i])
+                return false;
+        return true;
+    }
+
+    void imprimir() const {
+        for (int i = 0; i < F; ++i) {
+            for (int j = 0; j < C; ++j)
+                cout << setw(5) << datos[i * C + j] << " ";
+            cout << endl;
+        }
+    }
+};
+
+// Alias de uso frecuente
+using Matriz3 = MatrizFija<double, 3, 3>;
+using Matriz4 = MatrizFija<double, 4, 4>;
+using Matriz3f = MatrizFija<float, 3, 3>;
+using Matriz4f = MatrizFija<float, 4, 4>;
+
+// Las operaciones de MatrizFija se evalúan en tiempo de compilación
+constexpr MatrizFija<int, 2, 3> fijaA{1, 2, 3, 4, 5, 6};
+constexpr MatrizFija<int, 3, 2> fijaB{7, 8, 9, 10, 11, 12};
+static_assert(fijaA * fijaB == MatrizFija<int, 2, 2>{58, 64, 139, 154}, "producto 2x3 * 3x2");
+static_assert(fijaA.transpuesta() == MatrizFija<int, 3, 2>{1, 4, 2, 5, 3, 6}, "transpuesta");
+static_assert(fijaA + fijaA == fijaA * 2 && fijaA - fijaA == MatrizFija<int, 2, 3>(), "suma, resta y escalado");
+static_assert(MatrizFija<int, 3, 3>::identidad() * fijaB == fijaB, "identidad");
+static_assert(fijaA(1, 2) == 6 && fijaA.numFilas() == 2 && fijaA.numColumnas() == 3, "acceso y dimensiones");
+static_assert(!is_constructible<Matriz3, double, double>::value, "el número de valores debe ser F * C");
+static_assert(!is_constructible<MatrizFija<double, 1, 1>, Matriz3>::value, "una matriz no es un valor");
+
+#ifdef MATRIZ_PRUEBAS
+// Pruebas y mediciones. Se compilan con:
+//   g++ -std=c++17 -O2 -pthread -DMATRIZ_PRUEBAS "punto 2.cpp" -o pruebas
+// main devuelve 0 si todas las comprobaciones pasan; "./pruebas medir" ejecuta
+// además las mediciones de rendimiento.
+#include <chrono>
+#include <random>
+#include <cfloat>
+#include <cstdio>    // Para remove()
+
+static int fallos = 0;
+
+static void comprobar(bool condicion, const string& descripcion) {
+    cout << (condicion ? "[ok]    " : "[FALLO] ") << descripcion << endl;
+    if (!condicion)
+        ++fallos;
+}
+
+static bool iguales(const Matriz& A, const Matriz& B) {
+    if (A.tamano() != B.tamano())
+        return false;
+    for (int i = 0; i < A.tamano(); ++i)
+        for (int j = 0; j < A.tamano(); ++j)
+            if (A(i, j) != B(i, j))
+                return false;
+    return true;
+}
+
+// Matriz con valores reales aleatorios (no enteros, para que el orden de las
+// sumas se note en el redondeo)
+static Matriz aleatoria(int n, unsigned semilla) {
+    mt19937 gen(semilla);
+    uniform_real_distribution<double> u(-1, 1);
+    vector<double> v(size_t(n) * n);
+    for (double& x : v)
+        x = u(gen);
+    return Matriz(n, v.data());
+}
+
+static Matriz productoDevuelto(const Matriz& A, const Matriz& B) {
+    Matriz R = A.multiplicar(B);
+    return R;
+}
+
+// Las expresiones encadenadas y los resultados devueltos por valor se mueven,
+// nunca se copian: el contador de copias profundas no debe cambiar
+static void pruebaSinCopias() {
+    const int n = 64;
+    Matriz A(n), B(n);
+    long antes = Matriz::copiasProfundas;
+
+    Matriz C = A.multiplicar(B).transpuesta();
+    Matriz D = productoDevuelto(A, B).transpuesta().multiplicar(A);
+    Matriz E = Matriz::identidad(n);
+    E = A.multiplicar(E);
+    E = Matriz::ceros(n).sumar(A).escalar(2.0);
+    Matriz F = move(C);
+    vector<Matriz> lista;
+    lista.push_back(A.transpuesta());
+    lista.push_back(move(F));
+    Matriz G = A + B - 2.0 * D.T();
+
+    comprobar(Matriz::copiasProfundas == antes, "expresiones encadenadas sin copias profundas");
+    comprobar(iguales(E, A.escalar(2.0)), "ceros + A escalado por 2");
+
+    Matriz H = A;
+    comprobar(Matriz::copiasProfundas == antes + 1 && iguales(H, A), "una copia explícita cuenta una vez");
+}
+
+// Strassen-Winograd frente a la GEMM clásica, con tamaños pares e impares
+// (pelado dinámico) y varios cortes; el error relativo debe quedar cerca de u
+static void pruebaStrassen() {
+    for (int n : {1, 7, 64, 129, 300}) {
+        Matriz A(n), B(n);
+        Matriz C = A.multiplicar(B);
+        for (int corte : {1, 16, 64}) {
+            Matriz S = A.multiplicarStrassen(B, corte);
+            double maxDif = 0.0, maxC = 0.0;
+            for (int i = 0; i < n; ++i)
+                for (int j = 0; j < n; ++j) {
+                    maxDif = max(maxDif, fabs(S(i, j) - C(i, j)));
+                    maxC = max(maxC, fabs(C(i, j)));
+                }
+            comprobar(maxDif <= 1e-12 * max(maxC, 1.0),
+                      "Strassen n=" + to_string(n) + " corte=" + to_string(corte));
+        }
+    }
+}
+
+// Cada hilo calcula bloques completos de C con la misma dimensión interna, así
+// que el producto es idéntico bit a bit con 1 y con N hilos (también Strassen)
+static void pruebaHilos() {
+    int anteriores = Matriz::obtenerHilos();
+    for (int n : {130, 301, 517}) {
+        Matriz A = aleatoria(n, 1), B = aleatoria(n, 2);
+        Matriz::establecerHilos(1);
+        Matriz C1 = A.multiplicar(B), S1 = A.multiplicarStrassen(B, 64);
+        bool igual = true;
+        for (int h : {2, 3, max(4, int(thread::hardware_concurrency()))}) {
+            Matriz::establecerHilos(h);
+            igual &= iguales(A.multiplicar(B), C1) && iguales(A.multiplicarStrassen(B, 64), S1);
+        }
+        comprobar(igual, "multiplicar igual con 1 y N hilos, n=" + to_string(n));
+    }
+    Matriz::establecerHilos(anteriores);
+}
+
+// Cada núcleo que soporta la CPU (escalar, AVX2, AVX-512), forzado con
+// seleccionar(), frente al triple bucle, en tamaños que no son múltiplo del
+// micro-bloque 6 x 8 ni del bloque de transposición
+static void pruebaNucleos() {
+    const char* nombres[] = {"escalar", "AVX2", "AVX-512"};
+    for (auto nivel : {NucleosMatriz::ESCALAR, NucleosMatriz::AVX2, NucleosMatriz::AVX512}) {
+        if (nivel > NucleosMatriz::nivelDisponible())
+            continue;
+        NucleosMatriz::seleccionar(nivel);
+        bool producto = NucleosMatriz::tabla().nivel == nivel, elementos = producto;
+        for (int n : {1, 5, 13, 37, 131}) {
+            Matriz A = aleatoria(n, 3), B = aleatoria(n, 4);
+            Matriz C = A.multiplicar(B), S = A.sumar(B), R = A.restar(B), E = A.escalar(0.3), T = A.transpuesta();
+            Matriz X = A;
+            X.transponer();
+            for (int i = 0; i < n; ++i)
+                for (int j = 0; j < n; ++j) {
+                    double c = 0.0, cota = 0.0;
+                    for (int k = 0; k < n; ++k) {
+                        c += A(i, k) * B(k, j);
+                        cota += fabs(A(i, k) * B(k, j));
+                    }
+                    producto &= fabs(C(i, j) - c) <= 2 * n * DBL_EPSILON * cota;
+                    elementos &= S(i, j) == A(i, j) + B(i, j) && R(i, j) == A(i, j) - B(i, j) &&
+                                 E(i, j) == A(i, j) * 0.3 && T(i, j) == A(j, i) && X(i, j) == A(j, i);
+                }
+        }
+        comprobar(producto, string("multiplicar con el núcleo ") + nombres[nivel]);
+        comprobar(elementos, string("sumar, restar, escalar y transponer con el núcleo ") + nombres[nivel]);
+    }
+    NucleosMatriz::seleccionar(NucleosMatriz::nivelDisponible());
+}
+
+// Diferencia relativa máxima entre dos matrices del mismo tamaño
+static double diferencia(const Matriz& A, const Matriz& B) {
+    double dif = 0.0, escala = 1.0;
+    for (int i = 0; i < A.tamano(); ++i)
+        for (int j = 0; j < A.tamano(); ++j) {
+            dif = max(dif, fabs(A(i, j) - B(i, j)));
+            escala = max(escala, fabs(B(i, j)));
+        }
+    return dif / escala;
+}
+
+// Las expresiones perezosas dan lo mismo que las operaciones inmediatas, incluso
+// cuando el destino aparece transpuesto en la propia expresión
+static void pruebaExpresiones() {
+    for (int n : {5, 130}) {
+        Matriz A = aleatoria(n, 8), B = aleatoria(n, 9), X = aleatoria(n, 10);
+        Matriz At = A.transpuesta();
+        Matriz P = A.T() * B, Q = A * B.T();
+        comprobar(iguales(P, At.multiplicar(B)) && iguales(Q, A.multiplicar(B.transpuesta())),
+                  "A.T() * B y A * B.T() iguales al producto con la transpuesta, n=" + to_string(n));
+
+        Matriz L = 2.5 * A + B, M = A - B * 0.5 + A.T();
+        // Con -mfma el compilador puede fusionar k * a + b en la expresión: 1 ulp
+        comprobar(diferencia(L, A.escalar(2.5).sumar(B)) <= 1e-15 &&
+                  diferencia(M, A.restar(B.escalar(0.5)).sumar(At)) <= 1e-15,
+                  "a * A + B y A - B * k + A.T() iguales a las operaciones inmediatas, n=" + to_string(n));
+
+        Matriz esperado = X.transpuesta().sumar(X);
+        X = X.T() + X;
+        Matriz Y = A;
+        Y = Y.T() * 1.0 - Y;
+        comprobar(iguales(X, esperado) && iguales(Y, At.restar(A)),
+                  "X = X.T() + X sin leer celdas ya escritas, n=" + to_string(n));
+    }
+}
+
+// Matriz aleatoria con una fracción 'densidad' de no nulos y las filas y
+// columnas múltiplo de 7 vacías
+static Matriz dispersaAleatoria(int n, double densidad, unsigned semilla) {
+    mt19937 gen(semilla);
+    uniform_real_distribution<double> u(-1, 1), p(0, 1);
+    vector<double> v(size_t(n) * n, 0.0);
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            if (i % 7 != 0 && j % 7 != 0 && p(gen) < densidad)
+                v[size_t(i) * n + j] = u(gen);
+    return Matriz(n, v.data());
+}
+
+// Construcción en CSR y CSC, conversión entre formatos y productos disperso x
+// denso y disperso x disperso (Gustavson) frente a los productos densos
+static void pruebaDispersa() {
+    for (int n : {1, 20, 200}) {
+        Matriz A = dispersaAleatoria(n, 0.05, 11), B = dispersaAleatoria(n, 0.1, 12), D = aleatoria(n, 13);
+        size_t noNulos = 0;
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j)
+                noNulos += A(i, j) != 0.0;
+        MatrizDispersa csr(A), csc(A, 0.0, MatrizDispersa::CSC), bcsr(B), bcsc(B, 0.0, MatrizDispersa::CSC);
+        bool construccion = csr.noNulos() == noNulos && csc.noNulos() == noNulos &&
+                            csr.obtenerFormato() == MatrizDispersa::CSR && csc.obtenerFormato() == MatrizDispersa::CSC &&
+                            iguales(csr.aDensa(), A) && iguales(csc.aDensa(), A) &&
+                            iguales(csr.convertir(MatrizDispersa::CSC).aDensa(), A) &&
+                            iguales(csc.convertir(MatrizDispersa::CSR).aDensa(), A) &&
+                            iguales(csr.transpuesta().aDensa(), A.transpuesta());
+        comprobar(construccion, "dispersa en CSR y CSC, con filas vacías, n=" + to_string(n));
+
+        Matriz AD = A.multiplicar(D), AB = A.multiplicar(B);
+        comprobar(diferencia(csr.multiplicar(D), AD) <= 1e-14 && diferencia(csc.multiplicar(D), AD) <= 1e-14,
+                  "disperso x denso igual al producto denso, n=" + to_string(n));
+        bool gustavson = true;
+        for (const MatrizDispersa* x : {&csr, &csc})
+            for (const MatrizDispersa* y : {&bcsr, &bcsc}) {
+                MatrizDispersa C = x->multiplicar(*y);
+                gustavson &= C.obtenerFormato() == MatrizDispersa::CSR && diferencia(C.aDensa(), AB) <= 1e-14;
+            }
+        comprobar(gustavson, "disperso x disperso (Gustavson) igual al producto denso, n=" + to_string(n));
+    }
+
+    Matriz ceros = Matriz::ceros(50);
+    MatrizDispersa vacia(ceros);
+    Matriz D = aleatoria(50, 14);
+    comprobar(vacia.noNulos() == 0 && iguales(vacia.multiplicar(D), ceros) &&
+              vacia.multiplicar(MatrizDispersa(D)).noNulos() == 0,
+              "dispersa sin no nulos");
+    Matriz pequenos = aleatoria(50, 15).escalar(1e-3);
+    pequenos(3, 4) = 5.0;
+    comprobar(MatrizDispersa(pequenos, 0.01).noNulos() == 1, "la tolerancia descarta los valores pequeños");
+}
+
+// Escribe un archivo con la cabecera dada y 'valores' doubles a cero
+static void escribirCrudo(const string& ruta, const Matriz::Cabecera& c, size_t valores) {
+    ofstream salida(ruta, ios::binary);
+    salida.write(reinterpret_cast<const char*>(&c), sizeof c);
+    vector<double> ceros(valores, 0.0);
+    salida.write(reinterpret_cast<const char*>(ceros.data()), streamsize(sizeof(double) * valores));
+}
+
+static bool cargarLanza(const string& ruta) {
+    try {
+        Matriz::cargar(ruta);
+    } catch (const runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+// guardar() y cargar() de ida y vuelta (escribir en la matriz mapeada no toca el
+// archivo) y archivos inválidos: magia incorrecta, truncados, tamaño que desborda
+// filas * filas * 8 y archivo inexistente
+static void pruebaArchivo() {
+    const string ruta = "prueba_matriz.bin";
+    for (int n : {0, 1, 37, 300}) {
+        Matriz A = aleatoria(n, 16);
+        A.guardar(ruta);
+        Matriz B = Matriz::cargar(ruta);
+        bool bien = iguales(A, B);
+        if (n > 0) {
+            B(0, 0) = 1e300;
+            bien &= iguales(Matriz::cargar(ruta), A);
+        }
+        comprobar(bien, "guardar y cargar, n=" + to_string(n));
+    }
+
+    Matriz::Cabecera c = Matriz::cabeceraPara(4);
+    c.magia[0] = 'X';
+    escribirCrudo(ruta, c, 16);
+    bool magia = cargarLanza(ruta);
+    c = Matriz::cabeceraPara(4);
+    escribirCrudo(ruta, c, 15);
+    bool truncado = cargarLanza(ruta);
+    { ofstream(ruta, ios::binary).write("MATRIZ", 6); }
+    bool sinCabecera = cargarLanza(ruta);
+    c = Matriz::cabeceraPara(INT_MAX);  // INT_MAX^2 * 8 no cabe en 64 bits
+    escribirCrudo(ruta, c, 16);
+    bool desborde = cargarLanza(ruta);
+    c.filas = c.columnas = uint64_t(1) << 33;
+    escribirCrudo(ruta, c, 16);
+    bool enorme = cargarLanza(ruta);
+    remove(ruta.c_str());
+    bool inexistente = cargarLanza(ruta);
+    comprobar(magia && truncado && sinCabecera && desborde && enorme && inexistente,
+              "cargar lanza runtime_error con magia, tamaño o longitud inválidos");
+}
+
+// Producto de MatrizDinamica frente al triple bucle en formas rectangulares que no
+// son múltiplo del micro-bloque (4 filas x 2 vectores) ni de los bloques de caché
+template <class T>
+static bool productoDinamicoCorrecto(int m, int k, int nc, double tolerancia) {
+    mt19937 gen(m * 131 + k * 17 + nc);
+    uniform_int_distribution<int> u(-4, 4);
+    MatrizDinamica<T> A(m, k), B(k, nc);
+    for (int i = 0; i < m; ++i)
+        for (int p = 0; p < k; ++p)
+            A(i, p) = T(u(gen)) / T(2);
+    for (int p = 0; p < k; ++p)
+        for (int j = 0; j < nc; ++j)
+            B(p, j) = T(u(gen));
+    MatrizDinamica<T> C = A.multiplicar(B);
+    bool bien = C.numFilas() == m && C.numColumnas() == nc;
+    for (int i = 0; i < m; ++i)
+        for (int j = 0; j < nc; ++j) {
+            double c = 0.0;
+            for (int p = 0; p < k; ++p)
+                c += double(A(i, p)) * double(B(p, j));
+            bien &= fabs(double(C(i, j)) - c) <= tolerancia * max(1.0, fabs(c));
+        }
+    return bien;
+}
+
+// MatrizDinamica con varios tipos y formas, y MatrizFija en tiempo de ejecución
+// (sus operaciones constexpr se comprueban con static_assert tras su definición)
+static void pruebaGenericas() {
+    bool producto = true;
+    for (auto forma : vector<array<int, 3>>{{1, 1, 1}, {3, 5, 7}, {13, 130, 37}, {65, 257, 300}, {200, 3, 129}}) {
+        producto &= productoDinamicoCorrecto<double>(forma[0], forma[1], forma[2], 0.0);
+        producto &= productoDinamicoCorrecto<float>(forma[0], forma[1], forma[2], 0.0);
+        producto &= productoDinamicoCorrecto<int>(forma[0], forma[1], forma[2] / 2 + 1, 0.0);
+    }
+    comprobar(producto, "producto de MatrizDinamica<double, float, int> rectangular");
+
+    Matriz M = aleatoria(9, 17);
+    MatrizDinamica<double> D(M);
+    MatrizDinamica<float> F(D);
+    MatrizDinamica<double> I = MatrizDinamica<double>::identidad(9);
+    bool conversiones = D.numFilas() == 9 && D.numColumnas() == 9;
+    MatrizDinamica<double> S = D.sumar(I), R = D.restar(I), E = D.escalar(3.0), P = D.multiplicar(I);
+    for (int i = 0; i < 9; ++i)
+        for (int j = 0; j < 9; ++j) {
+            conversiones &= D(i, j) == M(i, j) && F(i, j) == float(M(i, j)) && P(i, j) == D(i, j);
+            conversiones &= S(i, j) == D(i, j) + (i == j) && R(i, j) == D(i, j) - (i == j) &&
+                            E(i, j) == D(i, j) * 3.0;
+        }
+    comprobar(conversiones, "MatrizDinamica desde Matriz, a float, identidad, suma, resta y escala");
+
+    MatrizFija<double, 1, 1> uno{2.5};
+    MatrizFija<double, 1, 1> copia(uno);  // Lvalue no constante: constructor de copia
+    Matriz4 rotacion{0, -1, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+    Matriz4 giro = rotacion * rotacion * rotacion * rotacion;
+    comprobar(copia(0, 0) == 2.5 && giro == Matriz4::identidad() &&
+              rotacion.transpuesta() * rotacion == Matriz4::identidad(),
+              "MatrizFija: copia 1 x 1 y rotaciones 4 x 4");
+}
+
+// transponer() en el sitio con tamaños alrededor de los bloques y de las tareas
+// paralelas, la transpuesta de MatrizDinamica en formas rectangulares, y la vista
+// transpuesta con sus productos frente a la transpuesta explícita
+static void pruebaTranspuesta() {
+    bool enSitio = true;
+    for (int n : {1, 3, 8, 9, 31, 32, 33, 100, 129, 300}) {
+        Matriz A = aleatoria(n, 5), X = A;
+        X.transponer();
+        enSitio &= iguales(X, A.transpuesta());
+        X.transponer();
+        enSitio &= iguales(X, A);
+    }
+    comprobar(enSitio, "transponer() en el sitio igual a transpuesta() y doble transposición");
+
+    bool rectangular = true;
+    for (auto forma : vector<pair<int, int>>{{1, 5}, {3, 7}, {33, 65}, {64, 31}}) {
+        MatrizDinamica<double> M = MatrizDinamica<double>::ceros(forma.first, forma.second);
+        for (int i = 0; i < forma.first; ++i)
+            for (int j = 0; j < forma.second; ++j)
+                M(i, j) = i * 1000 + j;
+        MatrizDinamica<double> T = M.transpuesta();
+        rectangular &= T.numFilas() == forma.second && T.numColumnas() == forma.first;
+        for (int i = 0; i < forma.first; ++i)
+            for (int j = 0; j < forma.second; ++j)
+                rectangular &= T(j, i) == M(i, j);
+    }
+    comprobar(rectangular, "transpuesta de MatrizDinamica rectangular");
+
+    for (int n : {7, 130}) {
+        Matriz A = aleatoria(n, 6), B = aleatoria(n, 7);
+        Matriz At = A.transpuesta(), Bt = B.transpuesta();
+        Matriz::VistaTranspuesta vista = A.vistaTranspuesta();
+        bool lectura = vista.tamano() == n && iguales(vista.materializar(), At);
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j)
+                lectura &= vista(i, j) == A(j, i);
+        comprobar(lectura, "vistaTranspuesta lee A(j, i), n=" + to_string(n));
+        comprobar(diferencia(vista.multiplicar(B), At.multiplicar(B)) <= 1e-14 &&
+                  diferencia(A.multiplicar(B.vistaTranspuesta()), A.multiplicar(Bt)) <= 1e-14,
+                  "A^T B y A B^T con la vista iguales a la transpuesta explícita, n=" + to_string(n));
+    }
+}
+
+static double segundosDesde(chrono::steady_clock::time_point inicio) {
+    return chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+}
+
+// GFLOP/s de multiplicar() frente a la implementación original: filas sueltas
+// (double**) y el triple bucle i-j-k que recorre B por columnas
+static void medirMultiplicacion() {
+    cout << "\n  n   original GFLOP/s   multiplicar() GFLOP/s (" << Matriz::obtenerHilos() << " hilos)" << endl;
+    for (int n : {128, 256, 512, 1024, 2048}) {
+        Matriz A(n), B(n);
+        double flops = 2.0 * n * n * n;
+
+        double ingenuo = 0.0;
+        if (n <= 1024) {
+            vector<vector<double>> a(n, vector<double>(n)), b(n, vector<double>(n)), c(n, vector<double>(n, 0.0));
+            for (int i = 0; i < n; ++i)
+                for (int j = 0; j < n; ++j) {
+                    a[i][j] = A(i, j);
+                    b[i][j] = B(i, j);
+                }
+            auto t0 = chrono::steady_clock::now();
+            for (int i = 0; i < n; ++i)
+                for (int j = 0; j < n; ++j)
+                    for (int k = 0; k < n; ++k)
+                        c[i][j] += a[i][k] * b[k][j];
+            ingenuo = flops / segundosDesde(t0) * 1e-9;
+        }
+
+        auto t0 = chrono::steady_clock::now();
+        Matriz C = A.multiplicar(B);
+        double bloques = flops / segundosDesde(t0) * 1e-9;
+        cout << setw(5) << n << setw(14);
+        if (n <= 1024)
+            cout << fixed << setprecision(2) << ingenuo;
+        else
+            cout << "-";
+        cout << setw(20) << fixed << setprecision(2) << bloques << endl;
+    }
+}
+
+// Tiempo de multiplicarStrassen() para varios cortes frente a la GEMM clásica,
+// para localizar a partir de qué tamaño compensa la recursión
+static void medirStrassen() {
+    cout << "\n  n   clásica s   corte 128 s   corte 256 s   corte 512 s" << endl;
+    for (int n : {512, 1024, 2048}) {
+        Matriz A(n), B(n);
+        auto t0 = chrono::steady_clock::now();
+        Matriz C = A.multiplicar(B);
+        cout << setw(5) << n << setw(11) << fixed << setprecision(3) << segundosDesde(t0);
+        for (int corte : {128, 256, 512}) {
+            t0 = chrono::steady_clock::now();
+            Matriz S = A.multiplicarStrassen(B, corte);
+            cout << setw(14) << fixed << setprecision(3) << segundosDesde(t0);
+        }
+        cout << endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    pruebaSinCopias();
+    pruebaStrassen();
+    pruebaHilos();
+    pruebaNucleos();
+    pruebaTranspuesta();
+    pruebaExpresiones();
+    pruebaDispersa();
+    pruebaArchivo();
+    pruebaGenericas();
+    if (argc > 1 && string(argv[1]) == "medir") {
+        medirMultiplicacion();
+        medirStrassen();
+    }
+    cout << (fallos == 0 ? "Todas las pruebas pasaron" : "Hay pruebas que fallaron") << endl;
+    return fallos == 0 ? 0 : 1;
+}
+#endif
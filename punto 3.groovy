@@ -1,27 +1,559 @@
 #include <iostream>
 #include <cmath>
+#include <complex>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <cfloat>
+#include <stdexcept>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
 using namespace std;
 
 class Polinomio {
 private:
+    // Hasta grado 8 los coeficientes caben en el propio objeto y no se usa el heap
+    static const int CAPACIDAD_LOCAL = 9;
+
     int grado;          // Grado del polinomio
+    int capacidad;      // Coeficientes que caben en coef sin reservar de nuevo
     double* coef;       // Coeficientes del polinomio (coef[i] corresponde a x^i)
+    double local[CAPACIDAD_LOCAL]; // Almacenamiento interno para grados pequeños
+
+    bool esLocal() const {
+        return coef == local;
+    }
+
+    // Deja sitio para n + 1 coeficientes sin inicializar; si ya había memoria
+    // propia del heap se libera antes
+    void reservar(int n) {
+        if (n + 1 > capacidad || coef == nullptr) {
+            liberar();
+            if (n + 1 <= CAPACIDAD_LOCAL) {
+                coef = local;
+                capacidad = CAPACIDAD_LOCAL;
+            } else {
+                coef = new double[n + 1];
+                capacidad = n + 1;
+            }
+        }
+        grado = n;
+    }
+
+    void liberar() {
+        if (coef != nullptr && !esLocal())
+            delete[] coef;
+        coef = nullptr;
+        capacidad = 0;
+    }
+
+    // Toma los coeficientes de 'otro': si estaban en el heap se roba el puntero y,
+    // si eran internos, se copian. 'otro' queda como el polinomio cero
+    void tomar(Polinomio& otro) {
+        if (otro.esLocal()) {
+            reservar(otro.grado);
+            copy(otro.coef, otro.coef + otro.grado + 1, coef);
+        } else {
+            liberar();
+            grado = otro.grado;
+            capacidad = otro.capacidad;
+            coef = otro.coef;
+            otro.coef = otro.local;
+            otro.capacidad = CAPACIDAD_LOCAL;
+        }
+        otro.grado = 0;
+        otro.coef[0] = 0.0;
+    }
+
+    // Umbrales de la multiplicación, medidos con polinomios densos de igual grado:
+    // por debajo de UMBRAL_KARATSUBA coeficientes se usa el producto directo y desde
+    // UMBRAL_FFT coeficientes del factor más corto, la FFT
+    static const int UMBRAL_KARATSUBA = 128;
+    static const int UMBRAL_FFT = 512;
+    static const int BASE_KARATSUBA = 32; // Tamaño en que la recursión pasa al directo
+
+    // Constructor interno: reserva grado + 1 coeficientes sin inicializar para que
+    // los algoritmos escriban el resultado directamente, sin copia intermedia
+    struct SinInicializar {};
+    Polinomio(int n, SinInicializar) : grado(0), capacidad(0), coef(nullptr) {
+        reservar(n);
+    }
+
+    // r[0, na + nb - 1) = a * b por el método directo
+    static void productoDirecto(const double* a, int na, const double* b, int nb, double* r) {
+        fill(r, r + na + nb - 1, 0.0);
+        for (int i = 0; i < na; ++i)
+            for (int j = 0; j < nb; ++j)
+                r[i + j] += a[i] * b[j];
+    }
+
+    // r[0, 2n - 1) = a * b con Karatsuba para dos factores de n coeficientes.
+    // 'tmp' es espacio de trabajo de al menos 8n doubles
+    static void karatsuba(const double* a, const double* b, int n, double* r, double* tmp) {
+        if (n <= BASE_KARATSUBA) {
+            productoDirecto(a, n, b, n, r);
+            return;
+        }
+        int h = n / 2, k = n - h; // a = a0 + x^h a1, con a0 de h y a1 de k coeficientes
+        // z0 = a0 b0 en r[0, 2h - 1) y z2 = a1 b1 en r[2h, 2n - 1)
+        karatsuba(a, b, h, r, tmp);
+        r[2 * h - 1] = 0.0;
+        karatsuba(a + h, b + h, k, r + 2 * h, tmp);
+        // z1 = (a0 + a1)(b0 + b1) - z0 - z2, que se suma a partir de x^h
+        double* sa = tmp;
+        double* sb = tmp + k;
+        double* z1 = tmp + 2 * k;
+        for (int i = 0; i < k; ++i) {
+            sa[i] = a[h + i] + (i < h ? a[i] : 0.0);
+            sb[i] = b[h + i] + (i < h ? b[i] : 0.0);
+        }
+        karatsuba(sa, sb, k, z1, tmp + 4 * k);
+        for (int i = 0; i < 2 * h - 1; ++i)
+            z1[i] -= r[i];
+        for (int i = 0; i < 2 * k - 1; ++i)
+            z1[i] -= r[2 * h + i];
+        for (int i = 0; i < 2 * k - 1; ++i)
+            r[h + i] += z1[i];
+    }
+
+    // Producto con Karatsuba de factores de distinto tamaño (na >= nb): el largo se
+    // corta en trozos de nb coeficientes y cada trozo se multiplica por el corto
+    static void productoKaratsuba(const double* a, int na, const double* b, int nb, double* r) {
+        vector<double> trozo(nb), parcial(2 * nb - 1), tmp(8 * size_t(nb) + 64);
+        fill(r, r + na + nb - 1, 0.0);
+        for (int inicio = 0; inicio < na; inicio += nb) {
+            int largo = min(nb, na - inicio);
+            const double* t = a + inicio;
+            if (largo < nb) {
+                // El último trozo se completa con ceros
+                fill(copy(t, t + largo, trozo.begin()), trozo.end(), 0.0);
+                t = trozo.data();
+            }
+            karatsuba(t, b, nb, parcial.data(), tmp.data());
+            for (int i = 0; i < min(2 * nb - 1, na + nb - 1 - inicio); ++i)
+                r[inicio + i] += parcial[i];
+        }
+    }
+
+    // r[0, na + nb - 1) = a * b con el algoritmo adecuado al factor más corto
+    static void producto(const double* a, int na, const double* b, int nb, double* r) {
+        if (na < nb) {
+            swap(a, b);
+            swap(na, nb);
+        }
+        if (nb < UMBRAL_KARATSUBA)
+            productoDirecto(a, na, b, nb, r);
+        else if (nb < UMBRAL_FFT)
+            productoKaratsuba(a, na, b, nb, r);
+        else
+            productoFFT(a, na, b, nb, r);
+    }
+
+    // Evaluación en bloque: Horner con varias cadenas independientes (una por
+    // carril de cada vector) para no quedar limitado por la latencia de la FPU.
+    // El ancho del vector sigue a la arquitectura de compilación. vector_size es
+    // una extensión de GCC y Clang; con otros compiladores Vec es un solo carril
+    // escalar con las mismas operaciones, y las cadenas siguen siendo independientes
+#if defined(__GNUC__)
+#if defined(__AVX512F__)
+    typedef double Vec __attribute__((vector_size(64)));
+#elif defined(__AVX__)
+    typedef double Vec __attribute__((vector_size(32)));
+#else
+    typedef double Vec __attribute__((vector_size(16)));
+#endif
+#else
+    struct Vec {
+        double v;
+        Vec() = default;
+        Vec(double x) : v(x) {}
+        double operator[](int) const { return v; }
+        double& operator[](int) { return v; }
+        Vec& operator+=(Vec b) { v += b.v; return *this; }
+        Vec& operator-=(Vec b) { v -= b.v; return *this; }
+        friend Vec operator+(Vec a, Vec b) { return a.v + b.v; }
+        friend Vec operator-(Vec a, Vec b) { return a.v - b.v; }
+        friend Vec operator*(Vec a, Vec b) { return a.v * b.v; }
+        friend Vec operator/(Vec a, Vec b) { return a.v / b.v; }
+    };
+#endif
+    static const int CARRILES = sizeof(Vec) / sizeof(double);
+    static const int CADENAS = 4; // Vectores evaluados a la vez
+    static const int UMBRAL_ESTRIN = 64; // Grado desde el que un punto suelto usa Estrin
+
+    void evaluarTramo(const double* xs, double* ys, size_t n) const {
+        const size_t paso = size_t(CADENAS) * CARRILES;
+        size_t i = 0;
+        for (; i + paso <= n; i += paso) {
+            Vec x[CADENAS], y[CADENAS];
+            for (int c = 0; c < CADENAS; ++c) {
+                memcpy(&x[c], xs + i + c * CARRILES, sizeof(Vec));
+                y[c] = Vec{} + coef[grado];
+            }
+            for (int k = grado - 1; k >= 0; --k)
+                for (int c = 0; c < CADENAS; ++c)
+                    y[c] = y[c] * x[c] + coef[k];
+            for (int c = 0; c < CADENAS; ++c)
+                memcpy(ys + i + c * CARRILES, &y[c], sizeof(Vec));
+        }
+        vector<double> tmp;
+        for (; i < n; ++i)
+            ys[i] = grado >= UMBRAL_ESTRIN ? evaluarEstrin(xs[i], tmp) : evaluar(xs[i]);
+    }
+
+    // Esquema de Estrin: agrupa los coeficientes por parejas con x, luego con x^2,
+    // x^4, ... Tiene profundidad log2(grado) en lugar de grado, así que un solo
+    // punto de grado alto aprovecha el paralelismo de la FPU
+    double evaluarEstrin(double x, vector<double>& tmp) const {
+        tmp.assign(coef, coef + grado + 1);
+        size_t largo = tmp.size();
+        double potencia = x;
+        while (largo > 1) {
+            size_t mitad = (largo + 1) / 2;
+            for (size_t j = 0; j < largo / 2; ++j)
+                tmp[j] = tmp[2 * j] + tmp[2 * j + 1] * potencia;
+            if (largo % 2)
+                tmp[mitad - 1] = tmp[largo - 1];
+            largo = mitad;
+            potencia *= potencia;
+        }
+        return tmp[0];
+    }
+
+    // Primeros 'corte' coeficientes de a * b
+    static vector<double> productoTruncado(const double* a, int na, const double* b, int nb, int corte) {
+        na = min(na, corte);
+        nb = min(nb, corte);
+        vector<double> r(na + nb - 1);
+        producto(a, na, b, nb, r.data());
+        r.resize(corte, 0.0);
+        return r;
+    }
+
+    // Inversa de la serie g (g[0] != 0) módulo x^k por iteración de Newton:
+    // h <- h (2 - g h), que duplica en cada paso los coeficientes correctos
+    static vector<double> inversaSerie(const double* g, int ng, int k) {
+        vector<double> h(1, 1.0 / g[0]);
+        for (int largo = 1; largo < k;) {
+            largo = min(2 * largo, k);
+            vector<double> e = productoTruncado(g, ng, h.data(), int(h.size()), largo);
+            for (double& v : e)
+                v = -v;
+            e[0] += 2.0;
+            h = productoTruncado(h.data(), int(h.size()), e.data(), largo, largo);
+        }
+        return h;
+    }
+
+    // Umbral de la división: con cociente y divisor de al menos tantos coeficientes
+    // la división larga O(m n) pasa a la inversión de Newton, que cuesta unas pocas
+    // multiplicaciones rápidas
+    static const int UMBRAL_DIVISION_NEWTON = 256;
+    // Los productos por FFT tienen un error relativo al coeficiente mayor, así que
+    // si la serie inversa crece más que esto se pierden los coeficientes pequeños
+    // del cociente y se vuelve a la división larga
+    static constexpr double CRECIMIENTO_MAXIMO = 1e4;
+
+    // f (nf coeficientes) = q g + r con g de ng coeficientes y g[ng - 1] != 0,
+    // nf >= ng. Escribe nf - ng + 1 coeficientes en q y ng - 1 en r
+    static void divisionLarga(const double* f, int nf, const double* g, int ng, double* q, double* r) {
+        vector<double> resto(f, f + nf);
+        for (int i = nf - ng; i >= 0; --i) {
+            q[i] = resto[i + ng - 1] / g[ng - 1];
+            for (int j = 0; j < ng; ++j)
+                resto[i + j] -= q[i] * g[j];
+        }
+        copy(resto.begin(), resto.begin() + ng - 1, r);
+    }
+
+    // Igual que divisionLarga, pero con la inversión de Newton cuando el tamaño
+    // lo justifica y la serie inversa es estable
+    static void dividirCoef(const double* f, int nf, const double* g, int ng, double* q, double* r) {
+        int m = nf - ng + 1;
+        if (m < UMBRAL_DIVISION_NEWTON || ng < UMBRAL_DIVISION_NEWTON) {
+            divisionLarga(f, nf, g, ng, q, r);
+            return;
+        }
+        // Con los coeficientes invertidos, rev(q) = rev(f) / rev(g) mod x^m
+        vector<double> fInv(f + ng - 1, f + nf), gInv(g, g + ng);
+        reverse(fInv.begin(), fInv.end());
+        reverse(gInv.begin(), gInv.end());
+        vector<double> h = inversaSerie(gInv.data(), ng, m);
+        double mayor = 0.0;
+        for (double v : h)
+            mayor = max(mayor, fabs(v));
+        if (!(mayor <= CRECIMIENTO_MAXIMO * fabs(h[0]))) {
+            divisionLarga(f, nf, g, ng, q, r);
+            return;
+        }
+        vector<double> qInv = productoTruncado(fInv.data(), m, h.data(), m, m);
+        reverse_copy(qInv.begin(), qInv.end(), q);
+        // r = f - q g, del que solo interesan los ng - 1 coeficientes bajos
+        vector<double> qg = productoTruncado(q, m, g, ng, ng - 1);
+        for (int i = 0; i < ng - 1; ++i)
+            r[i] = f[i] - qg[i];
+    }
+
+    // Quita los coeficientes principales de valor absoluto <= tolerancia
+    void recortar(double tolerancia) {
+        while (grado > 0 && fabs(coef[grado]) <= tolerancia)
+            --grado;
+    }
+
+    double normaMaxima() const {
+        double m = 0.0;
+        for (int i = 0; i <= grado; ++i)
+            m = max(m, fabs(coef[i]));
+        return m;
+    }
+
+    // Grado desde el que raices() reparte cada iteración entre hilos: un paso cuesta
+    // ~n^2 operaciones y por debajo la sincronización de cada ronda no compensa
+    static const int GRADO_PARALELO_ABERTH = 512;
+
+    // Hilos que se crean una sola vez y ejecutan trabajo(h) en cada ronda, con h = 0
+    // en el hilo que llama. Para métodos iterativos, donde crear y unir hilos en
+    // cada iteración costaría tanto como el propio paso
+    class Rondas {
+    private:
+        unsigned hilos;
+        function<void(unsigned)> trabajo;
+        vector<thread> grupo;
+        mutex m;
+        condition_variable inicio, fin;
+        long long ronda = 0;
+        unsigned pendientes = 0;
+        bool terminar = false;
+
+        void trabajador(unsigned h) {
+            long long vista = 0;
+            for (;;) {
+                {
+                    unique_lock<mutex> cerrojo(m);
+                    inicio.wait(cerrojo, [&] { return terminar || ronda != vista; });
+                    if (terminar)
+                        return;
+                    vista = ronda;
+                }
+                trabajo(h);
+                lock_guard<mutex> cerrojo(m);
+                if (--pendientes == 0)
+                    fin.notify_one();
+            }
+        }
+
+        void detener() {
+            {
+                lock_guard<mutex> cerrojo(m);
+                terminar = true;
+            }
+            inicio.notify_all();
+            for (thread& t : grupo)
+                t.join();
+            grupo.clear();
+        }
+
+    public:
+        Rondas(unsigned n, function<void(unsigned)> f) : hilos(max(1u, n)), trabajo(move(f)) {
+            try {
+                for (unsigned h = 1; h < hilos; ++h)
+                    grupo.emplace_back(&Rondas::trabajador, this, h);
+            } catch (...) {
+                detener();
+                throw;
+            }
+        }
+
+        Rondas(const Rondas&) = delete;
+        Rondas& operator=(const Rondas&) = delete;
+
+        // Ejecuta una ronda y vuelve cuando todos los hilos la han terminado
+        void ejecutar() {
+            {
+                lock_guard<mutex> cerrojo(m);
+                ++ronda;
+                pendientes = unsigned(grupo.size());
+            }
+            inicio.notify_all();
+            trabajo(0);
+            unique_lock<mutex> cerrojo(m);
+            fin.wait(cerrojo, [&] { return pendientes == 0; });
+        }
+
+        ~Rondas() {
+            detener();
+        }
+    };
+
+    // Un paso de Aberth-Ehrlich para las raíces [desde, hasta) del polinomio a
+    // (grado n, a[n] != 0). Es de tipo Jacobi: lee las aproximaciones de (zr, zi)
+    // y escribe las nuevas en (nr, ni), así que los tramos se pueden repartir
+    // entre hilos. Marca 'listo' cuando el error hacia atrás de p(z) ya es del
+    // orden del redondeo o la corrección no cambia z
+    static void pasoAberth(const double* a, int n, const double* zr, const double* zi, double* nr,
+                           double* ni, unsigned char* listo, int desde, int hasta) {
+        const double EPS = DBL_EPSILON;
+        for (int i = desde; i < hasta; ++i) {
+            nr[i] = zr[i];
+            ni[i] = zi[i];
+            if (listo[i])
+                continue;
+            complex<double> z(zr[i], zi[i]), p, dp, cociente; // cociente = p / p'
+            double cota = 0.0;
+            if (abs(z) <= 1.0) {
+                double m = abs(z);
+                for (int k = n; k >= 0; --k) {
+                    dp = dp * z + p;
+                    p = p * z + a[k];
+                    cota = cota * m + fabs(a[k]);
+                }
+                cociente = p / dp;
+            } else {
+                // Fuera del disco unidad se evalúa el polinomio invertido en w = 1/z
+                // para no desbordar: p'/p = n/z - w^2 q'(w)/q(w)
+                complex<double> w = 1.0 / z;
+                double m = abs(w);
+                for (int k = 0; k <= n; ++k) {
+                    dp = dp * w + p;
+                    p = p * w + a[k];
+                    cota = cota * m + fabs(a[k]);
+                }
+                cociente = 1.0 / (double(n) * w - w * w * dp / p);
+            }
+            if (abs(p) <= 4.0 * EPS * cota || !isfinite(cociente.real()) || !isfinite(cociente.imag())) {
+                listo[i] = 1;
+                continue;
+            }
+
+            // Suma de 1 / (z_i - z_j) para j != i, en vectores
+            Vec sr{}, si{};
+            for (int tramo = 0; tramo < 2; ++tramo) {
+                int j = tramo == 0 ? 0 : i + 1, fin = tramo == 0 ? i : n;
+                for (; j + CARRILES <= fin; j += CARRILES) {
+                    Vec xr, xi;
+                    memcpy(&xr, zr + j, sizeof(Vec));
+                    memcpy(&xi, zi + j, sizeof(Vec));
+                    Vec dr = zr[i] - xr, di = zi[i] - xi;
+                    Vec d2 = dr * dr + di * di;
+                    sr += dr / d2;
+                    si -= di / d2;
+                }
+                for (; j < fin; ++j) {
+                    double dr = zr[i] - zr[j], di = zi[i] - zi[j], d2 = dr * dr + di * di;
+                    sr[0] += dr / d2;
+                    si[0] -= di / d2;
+                }
+            }
+            complex<double> suma;
+            for (int c = 0; c < CARRILES; ++c)
+                suma += complex<double>(sr[c], si[c]);
+
+            complex<double> correccion = cociente / (1.0 - cociente * suma);
+            nr[i] = zr[i] - correccion.real();
+            ni[i] = zi[i] - correccion.imag();
+            if (abs(correccion) <= EPS * abs(z))
+                listo[i] = 1;
+        }
+    }
+
+    // FFT iterativa radix-2 en su sitio (tamaño potencia de 2). 'raices' guarda en
+    // [h, 2h) las raíces e^(-iπj/h) de la etapa de semitamaño h
+    static void fft(vector<complex<double>>& x, const vector<complex<double>>& raices, bool inversa) {
+        size_t n = x.size();
+        for (size_t i = 1, j = 0; i < n; ++i) {
+            size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1)
+                j ^= bit;
+            j ^= bit;
+            if (i < j)
+                swap(x[i], x[j]);
+        }
+        for (size_t h = 1; h < n; h *= 2)
+            for (size_t k = 0; k < n; k += 2 * h)
+                for (size_t j = 0; j < h; ++j) {
+                    complex<double> w = inversa ? conj(raices[h + j]) : raices[h + j];
+                    complex<double> t = w * x[k + j + h];
+                    x[k + j + h] = x[k + j] - t;
+                    x[k + j] += t;
+                }
+    }
+
+    // Producto por FFT: a y b van en las partes real e imaginaria de una sola
+    // transformada; se separan por simetría, se multiplican y se invierte.
+    // El error absoluto es del orden de 1e-16 * log2(n) * max|a| * max|b| * n
+    static void productoFFT(const double* a, int na, const double* b, int nb, double* r) {
+        int largo = na + nb - 1;
+        size_t n = 1;
+        while (n < size_t(largo))
+            n *= 2;
+        const double pi = acos(-1.0);
+        vector<complex<double>> raices(max<size_t>(n, 2));
+        for (size_t h = 1; h < n; h *= 2)
+            for (size_t j = 0; j < h; ++j)
+                raices[h + j] = polar(1.0, -pi * double(j) / double(h));
+
+        vector<complex<double>> x(n);
+        for (int i = 0; i < na; ++i)
+            x[i].real(a[i]);
+        for (int i = 0; i < nb; ++i)
+            x[i].imag(b[i]);
+        fft(x, raices, false);
+
+        // A[k] = (X[k] + conj X[n-k]) / 2,  B[k] = (X[k] - conj X[n-k]) / 2i
+        vector<complex<double>> p(n);
+        for (size_t k = 0; k < n; ++k) {
+            complex<double> xk = x[k], xc = conj(x[(n - k) & (n - 1)]);
+            p[k] = (xk + xc) * (xk - xc) * complex<double>(0, -0.25);
+        }
+        fft(p, raices, true);
+        for (int i = 0; i < largo; ++i)
+            r[i] = p[i].real() / double(n);
+    }
+
+#ifdef POLINOMIO_PRUEBAS
+    // Las pruebas llaman a cada algoritmo de multiplicación por separado
+    friend struct PruebasPolinomio;
+#endif
 
 public:
     // Constructor que inicializa los coeficientes
-    Polinomio(int n, const double* coeficientes) : grado(n) {
-        coef = new double[grado + 1];
+    Polinomio(int n, const double* coeficientes) : grado(0), capacidad(0), coef(nullptr) {
+        reservar(n);
         for (int i = 0; i <= grado; ++i)
             coef[i] = coeficientes[i];
     }
 
     // Constructor de copia
-    Polinomio(const Polinomio& otro) : grado(otro.grado) {
-        coef = new double[grado + 1];
+    Polinomio(const Polinomio& otro) : grado(0), capacidad(0), coef(nullptr) {
+        reservar(otro.grado);
         for (int i = 0; i <= grado; ++i)
             coef[i] = otro.coef[i];
     }
 
+    // Constructor de movimiento: no reserva memoria
+    Polinomio(Polinomio&& otro) noexcept : grado(0), capacidad(0), coef(nullptr) {
+        tomar(otro);
+    }
+
+    // Asignación de copia; reutiliza la memoria propia si tiene capacidad suficiente
+    Polinomio& operator=(const Polinomio& otro) {
+        if (this != &otro) {
+            reservar(otro.grado);
+            copy(otro.coef, otro.coef + grado + 1, coef);
+        }
+        return *this;
+    }
+
+    // Asignación de movimiento
+    Polinomio& operator=(Polinomio&& otro) noexcept {
+        if (this != &otro)
+            tomar(otro);
+        return *this;
+    }
+
     // Método para evaluar el polinomio en un valor dado de x
     double evaluar(double x) const {
         double resultado = 0.0;
@@ -30,37 +562,169 @@ public:
         return resultado;
     }
 
+    // Evaluación en bloque: ys[i] = p(xs[i]) para n puntos. Intercala varias cadenas
+    // de Horner por carril SIMD y reparte los puntos entre hilos (0 = todos los
+    // núcleos) cuando hay trabajo suficiente. Da los mismos valores que evaluar(x)
+    // salvo el redondeo de FMA cuando el compilador la usa
+    void evaluar(const double* xs, double* ys, size_t n, unsigned hilos = 0) const {
+        if (hilos == 0)
+            hilos = max(1u, thread::hardware_concurrency());
+        // Al menos ~256K operaciones por hilo para que compense crearlo
+        size_t porHilo = max<size_t>(1, (size_t(1) << 18) / size_t(grado + 1));
+        hilos = unsigned(min<size_t>(hilos, (n + porHilo - 1) / porHilo));
+        if (hilos <= 1) {
+            evaluarTramo(xs, ys, n);
+            return;
+        }
+        vector<thread> grupo;
+        for (unsigned h = 1; h < hilos; ++h) {
+            size_t desde = n * h / hilos, hasta = n * (h + 1) / hilos;
+            grupo.emplace_back(&Polinomio::evaluarTramo, this, xs + desde, ys + desde, hasta - desde);
+        }
+        evaluarTramo(xs, ys, n / hilos);
+        for (thread& t : grupo)
+            t.join();
+    }
+
+    vector<double> evaluar(const vector<double>& xs, unsigned hilos = 0) const {
+        vector<double> ys(xs.size());
+        evaluar(xs.data(), ys.data(), xs.size(), hilos);
+        return ys;
+    }
+
     // Sobrecarga del operador suma
     Polinomio operator+(const Polinomio& p) const {
         int maxGrado = (grado > p.grado) ? grado : p.grado;
-        double* nuevoCoef = new double[maxGrado + 1];
+        Polinomio resultado(maxGrado, SinInicializar());
 
         for (int i = 0; i <= maxGrado; ++i) {
             double a = (i <= grado) ? coef[i] : 0.0;
             double b = (i <= p.grado) ? p.coef[i] : 0.0;
-            nuevoCoef[i] = a + b;
+            resultado.coef[i] = a + b;
         }
-
-        Polinomio resultado(maxGrado, nuevoCoef);
-        delete[] nuevoCoef;
         return resultado;
     }
 
-    // Sobrecarga del operador multiplicación
+    // Suma con un temporal a la izquierda (a + b + c): reutiliza su memoria
+    friend Polinomio operator+(Polinomio&& a, const Polinomio& b) {
+        a += b;
+        return move(a);
+    }
+
+    // Suma en el sitio; solo reserva si p tiene mayor grado que la capacidad actual
+    Polinomio& operator+=(const Polinomio& p) {
+        if (p.grado > grado) {
+            if (p.grado + 1 > capacidad) {
+                Polinomio mayor(p.grado, SinInicializar());
+                copy(coef, coef + grado + 1, mayor.coef);
+                fill(mayor.coef + grado + 1, mayor.coef + p.grado + 1, 0.0);
+                tomar(mayor);
+            } else {
+                fill(coef + grado + 1, coef + p.grado + 1, 0.0);
+                grado = p.grado;
+            }
+        }
+        for (int i = 0; i <= p.grado; ++i)
+            coef[i] += p.coef[i];
+        return *this;
+    }
+
+    // Sobrecarga del operador multiplicación. Elige el algoritmo según el tamaño
+    // del factor más corto: directo O(nm), Karatsuba O(n m^0.58) o FFT O(n log n),
+    // y escribe directamente en los coeficientes del resultado
     Polinomio operator*(const Polinomio& p) const {
-        int nuevoGrado = grado + p.grado;
-        double* nuevoCoef = new double[nuevoGrado + 1];
+        Polinomio resultado(grado + p.grado, SinInicializar());
+        producto(coef, grado + 1, p.coef, p.grado + 1, resultado.coef);
+        return resultado;
+    }
 
-        for (int i = 0; i <= nuevoGrado; ++i)
-            nuevoCoef[i] = 0.0;
+    // Multiplicación en el sitio. El producto necesita los factores intactos, así
+    // que se escribe aparte: en la pila si cabe en el almacenamiento interno o en
+    // un bloque nuevo que pasa a ser el del polinomio. Admite p *= p
+    Polinomio& operator*=(const Polinomio& p) {
+        int n = grado + p.grado;
+        if (n + 1 <= CAPACIDAD_LOCAL) {
+            double r[CAPACIDAD_LOCAL];
+            producto(coef, grado + 1, p.coef, p.grado + 1, r);
+            reservar(n);
+            copy(r, r + n + 1, coef);
+        } else {
+            Polinomio resultado(n, SinInicializar());
+            producto(coef, grado + 1, p.coef, p.grado + 1, resultado.coef);
+            tomar(resultado);
+        }
+        return *this;
+    }
 
-        for (int i = 0; i <= grado; ++i)
-            for (int j = 0; j <= p.grado; ++j)
-                nuevoCoef[i + j] += coef[i] * p.coef[j];
+    // División con resto: *this = cociente * divisor + resto, con el grado del resto
+    // menor que el del divisor (o 0). Los coeficientes principales nulos del
+    // divisor se ignoran; dividir entre el polinomio cero lanza domain_error.
+    // Para cociente y divisor grandes usa la inversión de Newton de la serie
+    // invertida, con coste O(n log n) gracias a la multiplicación por FFT
+    void dividir(const Polinomio& divisor, Polinomio& cociente, Polinomio& resto) const {
+        int ng = divisor.grado + 1;
+        while (ng > 1 && divisor.coef[ng - 1] == 0.0)
+            --ng;
+        if (divisor.coef[ng - 1] == 0.0)
+            throw domain_error("Polinomio: división entre el polinomio cero");
+        int nf = grado + 1;
+        if (nf < ng) {
+            cociente = Polinomio(0, SinInicializar());
+            cociente.coef[0] = 0.0;
+            resto = *this;
+            return;
+        }
+        // Se escribe en temporales por si cociente o resto son *this o el divisor
+        Polinomio q(nf - ng, SinInicializar()), r(max(ng - 2, 0), SinInicializar());
+        r.coef[0] = 0.0;
+        dividirCoef(coef, nf, divisor.coef, ng, q.coef, r.coef);
+        cociente = move(q);
+        resto = move(r);
+    }
 
-        Polinomio resultado(nuevoGrado, nuevoCoef);
-        delete[] nuevoCoef;
-        return resultado;
+    Polinomio operator/(const Polinomio& divisor) const {
+        Polinomio q(0, SinInicializar()), r(0, SinInicializar());
+        dividir(divisor, q, r);
+        return q;
+    }
+
+    Polinomio operator%(const Polinomio& divisor) const {
+        Polinomio q(0, SinInicializar()), r(0, SinInicializar());
+        dividir(divisor, q, r);
+        return r;
+    }
+
+    // Máximo común divisor mónico por el algoritmo de Euclides. En coma flotante
+    // un resto casi nulo cuenta como cero: se descartan los coeficientes con valor
+    // absoluto <= tolerancia veces la norma del dividendo. Es sensible a esa
+    // tolerancia cuando las raíces comunes solo lo son aproximadamente
+    Polinomio mcd(const Polinomio& otro, double tolerancia = 1e-10) const {
+        Polinomio a(*this), b(otro);
+        a.recortar(0.0);
+        b.recortar(0.0);
+        if (a.grado < b.grado)
+            swap(a, b);
+        Polinomio q(0, SinInicializar());
+        while (b.grado > 0 || b.coef[0] != 0.0) {
+            // Divisor mónico para que la escala no derive entre pasos
+            double principal = b.coef[b.grado];
+            for (int i = 0; i <= b.grado; ++i)
+                b.coef[i] /= principal;
+            double escala = a.normaMaxima();
+            Polinomio r(0, SinInicializar());
+            a.dividir(b, q, r);
+            r.recortar(tolerancia * escala);
+            if (r.grado == 0 && fabs(r.coef[0]) <= tolerancia * escala)
+                r.coef[0] = 0.0;
+            a = move(b);
+            b = move(r);
+        }
+        if (a.coef[a.grado] != 0.0) {
+            double principal = a.coef[a.grado];
+            for (int i = 0; i <= a.grado; ++i)
+                a.coef[i] /= principal;
+        }
+        return a;
     }
 
     // Método para derivar el polinomio
@@ -70,15 +734,89 @@ public:
             return Polinomio(0, c);
         }
 
-        double* nuevoCoef = new double[grado];
+        Polinomio derivada(grado - 1, SinInicializar());
         for (int i = 1; i <= grado; ++i)
-            nuevoCoef[i - 1] = i * coef[i];
-
-        Polinomio derivada(grado - 1, nuevoCoef);
-        delete[] nuevoCoef;
+            derivada.coef[i - 1] = i * coef[i];
         return derivada;
     }
 
+    // Todas las raíces complejas a la vez por el método de Aberth-Ehrlich, que
+    // converge de forma cúbica para raíces simples y lineal para las múltiples.
+    // Las aproximaciones iniciales salen del polígono de Newton de los coeficientes
+    // (una circunferencia por cada tramo, con el radio que este indica), así que
+    // funciona también con raíces de módulos muy distintos. Cada iteración cuesta
+    // O(n^2) y, desde GRADO_PARALELO_ABERTH, las correcciones de las raíces se
+    // reparten entre hilos (0 = todos los núcleos) creados una vez por llamada.
+    // Las raíces devueltas cumplen |p(z)| <= 4 eps sum |a_k||z|^k, salvo que se
+    // agoten las iteraciones
+    vector<complex<double>> raices(int maxIteraciones = 200, unsigned hilos = 0) const {
+        vector<complex<double>> resultado;
+        int alto = grado, bajo = 0;
+        while (alto > 0 && coef[alto] == 0.0)
+            --alto;
+        while (bajo < alto && coef[bajo] == 0.0) {
+            resultado.push_back(0.0); // Raíz en el origen
+            ++bajo;
+        }
+        const double* a = coef + bajo;
+        int n = alto - bajo;
+        if (n <= 0)
+            return resultado;
+
+        // Aproximaciones iniciales: envolvente superior de los puntos (k, log|a_k|)
+        vector<double> logA(n + 1);
+        vector<int> casco;
+        for (int k = 0; k <= n; ++k) {
+            if (a[k] == 0.0)
+                continue;
+            logA[k] = log(fabs(a[k]));
+            while (casco.size() >= 2) {
+                int k0 = casco[casco.size() - 2], k1 = casco.back();
+                if ((logA[k1] - logA[k0]) * (k - k0) > (logA[k] - logA[k0]) * (k1 - k0))
+                    break;
+                casco.pop_back();
+            }
+            casco.push_back(k);
+        }
+        const double DOS_PI = 6.283185307179586476925;
+        vector<double> zr, zi;
+        for (size_t t = 0; t + 1 < casco.size(); ++t) {
+            int m = casco[t + 1] - casco[t];
+            double radio = exp((logA[casco[t]] - logA[casco[t + 1]]) / m);
+            for (int j = 0; j < m; ++j) {
+                double angulo = DOS_PI * (j / double(m) + t / double(n)) + 0.4;
+                zr.push_back(radio * cos(angulo));
+                zi.push_back(radio * sin(angulo));
+            }
+        }
+
+        if (hilos == 0)
+            hilos = max(1u, thread::hardware_concurrency());
+        // Por encima del umbral, al menos ~256K operaciones por hilo y paso
+        if (n < GRADO_PARALELO_ABERTH)
+            hilos = 1;
+        else
+            hilos = unsigned(min<long long>(hilos, max(1LL, (long long)n * n / (1 << 18))));
+        vector<double> nr(n), ni(n);
+        vector<unsigned char> listo(n, 0);
+        // Los hilos se crean una vez por llamada; en cada iteración el hilo h corrige
+        // su tramo de raíces. zr/nr se intercambian entre rondas, con los hilos parados
+        Rondas rondas(hilos, [&](unsigned h) {
+            pasoAberth(a, n, zr.data(), zi.data(), nr.data(), ni.data(), listo.data(),
+                       int((long long)n * h / hilos), int((long long)n * (h + 1) / hilos));
+        });
+        for (int iteracion = 0; iteracion < maxIteraciones; ++iteracion) {
+            rondas.ejecutar();
+            swap(zr, nr);
+            swap(zi, ni);
+            if (count(listo.begin(), listo.end(), 0) == 0)
+                break;
+        }
+        for (int i = 0; i < n; ++i)
+            resultado.emplace_back(zr[i], zi[i]);
+        return resultado;
+    }
+
     // Método para imprimir el polinomio en forma estándar
     void imprimir() const {
         for (int i = grado; i >= 0; --i) {
@@ -93,6 +831,398 @@ public:
 
     // Destructor
     ~Polinomio() {
-        delete[] coef;
+        liberar();
+    }
+};
+
+#ifdef POLINOMIO_PRUEBAS
+// Pruebas y mediciones. El archivo es C++ pese a la extensión; se compilan con:
+//   g++ -std=c++17 -O2 -pthread -x c++ -DPOLINOMIO_PRUEBAS "punto 3.groovy" -o pruebas
+// main devuelve 0 si todas las comprobaciones pasan; "./pruebas medir" ejecuta
+// además las mediciones de rendimiento.
+#include <chrono>
+#include <random>
+#include <string>
+#include <iomanip>
+
+#include <cstdlib>
+#include <new>
+#include <atomic>
+
+// Contador de reservas: se sustituyen los operator new/delete globales para
+// comprobar qué operaciones tocan el heap. Es atómico porque la evaluación en
+// bloque y raices() reservan desde otros hilos
+static atomic<size_t> reservas{0};
+
+void* operator new(size_t n) {
+    ++reservas;
+    if (void* p = malloc(n ? n : 1))
+        return p;
+    throw bad_alloc();
+}
+
+void* operator new[](size_t n) {
+    return operator new(n);
+}
+
+// GCC avisa en falso de new/free desparejados al integrar estos operadores en línea
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+static int fallos = 0;
+
+static void comprobar(bool condicion, const string& descripcion) {
+    cout << (condicion ? "[ok]    " : "[FALLO] ") << descripcion << endl;
+    if (!condicion)
+        ++fallos;
+}
+
+static double segundosDesde(chrono::steady_clock::time_point inicio) {
+    return chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+}
+
+static vector<double> aleatorios(size_t n, mt19937& gen) {
+    uniform_real_distribution<double> u(-1, 1);
+    vector<double> v(n);
+    for (auto& x : v)
+        x = u(gen);
+    return v;
+}
+
+struct PruebasPolinomio {
+    // Karatsuba, FFT y operator* frente al producto directo, con factores de igual
+    // y distinto tamaño a ambos lados de los umbrales
+    static void producto() {
+        mt19937 gen(1);
+        for (auto tam : vector<pair<int, int>>{{1, 1}, {1, 6}, {4, 1}, {32, 32}, {33, 41}, {101, 8},
+                                               {128, 127}, {512, 511}, {1001, 601}, {5000, 3334}}) {
+            vector<double> a = aleatorios(tam.first, gen), b = aleatorios(tam.second, gen);
+            int na = tam.first, nb = tam.second, largo = na + nb - 1;
+            const double* mayor = na >= nb ? a.data() : b.data();
+            const double* menor = na >= nb ? b.data() : a.data();
+            vector<double> directo(largo), karatsuba(largo), fft(largo);
+            Polinomio::productoDirecto(a.data(), na, b.data(), nb, directo.data());
+            Polinomio::productoKaratsuba(mayor, max(na, nb), menor, min(na, nb), karatsuba.data());
+            Polinomio::productoFFT(a.data(), na, b.data(), nb, fft.data());
+            Polinomio c = Polinomio(na - 1, a.data()) * Polinomio(nb - 1, b.data());
+
+            double errK = 0.0, errF = 0.0, errOp = 0.0;
+            for (int i = 0; i < largo; ++i) {
+                errK = max(errK, fabs(karatsuba[i] - directo[i]));
+                errF = max(errF, fabs(fft[i] - directo[i]));
+                errOp = max(errOp, fabs(c.coef[i] - directo[i]));
+            }
+            double tolerancia = 1e-14 * max(na, nb) * log2(2.0 * largo);
+            comprobar(c.grado == largo - 1 && errK <= tolerancia && errF <= tolerancia && errOp <= tolerancia,
+                      "producto " + to_string(na) + " x " + to_string(nb) + " coeficientes");
+        }
+    }
+
+    // La evaluación en bloque (cadenas de Horner intercaladas, Estrin en la cola y
+    // reparto entre hilos) frente a Horner punto a punto
+    static void evaluacion() {
+        mt19937 gen(4);
+        for (int grado : {0, 5, 63, 64, 300}) {
+            vector<double> c = aleatorios(grado + 1, gen), xs = aleatorios(1001, gen);
+            Polinomio p(grado, c.data());
+            vector<double> ys = p.evaluar(xs), ysHilos(xs.size());
+            p.evaluar(xs.data(), ysHilos.data(), xs.size(), 4);
+            double err = 0.0, cota = 0.0;
+            for (size_t i = 0; i < xs.size(); ++i) {
+                double y = p.evaluar(xs[i]);
+                err = max(err, max(fabs(ys[i] - y), fabs(ysHilos[i] - y)));
+                cota = max(cota, fabs(y));
+            }
+            comprobar(ys.size() == xs.size() && err <= 1e-13 * max(cota, 1.0) * (grado + 1),
+                      "evaluación en bloque de grado " + to_string(grado));
+        }
+    }
+
+    static bool iguales(const Polinomio& p, const vector<double>& c) {
+        if (p.grado + 1 != int(c.size()))
+            return false;
+        for (int i = 0; i <= p.grado; ++i)
+            if (fabs(p.coef[i] - c[i]) > 1e-12 * (1 + fabs(c[i])))
+                return false;
+        return true;
+    }
+
+    // Hasta grado 8 ninguna operación reserva memoria; con grados mayores, mover
+    // no reserva y += solo reserva si no cabe en la capacidad actual
+    static void sinReservas() {
+        double a[5] = {1, -2, 3, 0.5, 1}, b[4] = {2, 0, -1, 4}, c[9] = {1, 1, 1, 1, 1, 1, 1, 1, 1};
+        size_t antes = reservas;
+        Polinomio A(4, a), B(3, b), C(8, c);
+        Polinomio S = A + B;
+        Polinomio P = A * B;
+        Polinomio T = A + B + C;
+        Polinomio D = C.derivar();
+        Polinomio M(move(P));
+        Polinomio X = A;
+        X = B;
+        X = move(C);
+        X += A;
+        Polinomio Y(2, a);
+        Y *= Y;
+        Y *= Y;
+        // El resultado se guarda antes de llamar a comprobar(), cuya descripción
+        // se construye en el heap
+        bool sinReservar = reservas == antes;
+        comprobar(sinReservar, "grado <= 8 sin reservas de memoria");
+        comprobar(iguales(S, {3, -2, 2, 4.5, 1}) && iguales(M, {2, -4, 5, 7, -9, 11.5, 1, 4}) &&
+                  iguales(T, {4, -1, 3, 5.5, 2, 1, 1, 1, 1}) && iguales(D, {1, 2, 3, 4, 5, 6, 7, 8}) &&
+                  iguales(X, {2, -1, 4, 1.5, 2, 1, 1, 1, 1}) && iguales(Y, {1, -8, 36, -104, 214, -312, 324, -216, 81}),
+                  "resultados de las operaciones sin reservas");
+
+        mt19937 gen(3);
+        vector<double> grande = aleatorios(301, gen), medio = aleatorios(151, gen);
+        Polinomio G(300, grande.data()), H(150, medio.data());
+        antes = reservas;
+        Polinomio N(move(G));
+        N += H;
+        Polinomio R(1, a);
+        R = move(N);
+        sinReservar = reservas == antes;
+        Polinomio U = R + H + H;
+        bool unaReserva = reservas == antes + 1;
+        comprobar(sinReservar && unaReserva && R.grado == 300 && U.grado == 300,
+                  "grado 300: mover y += no reservan, a + b + c reserva una vez");
+    }
+
+    // Error hacia atrás relativo máximo de las raíces: |p(z)| / sum |a_k||z|^k,
+    // evaluando el polinomio invertido fuera del disco unidad
+    static double errorRaices(const Polinomio& p, const vector<complex<double>>& raices) {
+        double peor = 0.0;
+        for (complex<double> z : raices) {
+            complex<double> v;
+            double cota = 0.0;
+            if (abs(z) <= 1.0) {
+                for (int k = p.grado; k >= 0; --k) {
+                    v = v * z + p.coef[k];
+                    cota = cota * abs(z) + fabs(p.coef[k]);
+                }
+            } else {
+                complex<double> w = 1.0 / z;
+                for (int k = 0; k <= p.grado; ++k) {
+                    v = v * w + p.coef[k];
+                    cota = cota * abs(w) + fabs(p.coef[k]);
+                }
+            }
+            peor = max(peor, abs(v) / cota);
+        }
+        return peor;
+    }
+
+    // Raíces conocidas, raíces en el origen y el mismo resultado con uno o varios
+    // hilos (cada paso es de tipo Jacobi, así que el reparto no cambia los valores)
+    static void raices() {
+        vector<double> esperadas = {1, 2, -3, 0.5, -4.5};
+        double uno[1] = {1};
+        Polinomio p(0, uno);
+        for (double r : esperadas) {
+            double f[2] = {-r, 1};
+            p *= Polinomio(1, f);
+        }
+        vector<complex<double>> z = p.raices();
+        bool bien = z.size() == esperadas.size();
+        for (double r : esperadas) {
+            double cerca = 1e30;
+            for (complex<double> w : z)
+                cerca = min(cerca, abs(w - r));
+            bien &= cerca < 1e-10;
+        }
+        comprobar(bien, "raíces de (x - 1)(x - 2)(x + 3)(x - 0.5)(x + 4.5)");
+
+        double d[5] = {0, 0, 2, 0, 1};
+        vector<complex<double>> z2 = Polinomio(4, d).raices();
+        int ceros = 0;
+        bien = z2.size() == 4;
+        for (complex<double> w : z2) {
+            if (abs(w) == 0.0)
+                ++ceros;
+            else
+                bien &= fabs(abs(w) - sqrt(2.0)) < 1e-12;
+        }
+        comprobar(bien && ceros == 2, "raíces de x^4 + 2x^2");
+
+        mt19937 gen(5);
+        vector<double> a = aleatorios(1201, gen);
+        Polinomio q(1200, a.data());
+        vector<complex<double>> serie = q.raices(200, 1), paralelo = q.raices(200, 3);
+        comprobar(serie == paralelo && errorRaices(q, serie) < 1e-13, "grado 1200: igual con 1 y 3 hilos");
+    }
+
+    // Mayor diferencia entre coeficientes, contando como cero los que faltan
+    static double diferencia(const Polinomio& a, const Polinomio& b) {
+        double d = 0.0;
+        for (int i = 0; i <= max(a.grado, b.grado); ++i)
+            d = max(d, fabs((i <= a.grado ? a.coef[i] : 0.0) - (i <= b.grado ? b.coef[i] : 0.0)));
+        return d;
+    }
+
+    static Polinomio desdeRaices(const vector<double>& raices) {
+        double uno[1] = {1};
+        Polinomio p(0, uno);
+        for (double r : raices) {
+            double f[2] = {-r, 1};
+            p *= Polinomio(1, f);
+        }
+        return p;
+    }
+
+    // f = q g + r con grado r < grado g, a ambos lados de UMBRAL_DIVISION_NEWTON; por
+    // encima, el cociente de Newton frente a la división larga y la vuelta a la
+    // división larga cuando la serie inversa crece demasiado
+    static void division() {
+        mt19937 gen(6);
+        const int umbral = Polinomio::UMBRAL_DIVISION_NEWTON;
+        for (auto tam : vector<pair<int, int>>{{1, 1}, {4, 7}, {21, 6}, {300, 1}, {600, 2 * umbral},
+                                               {2000, umbral + 1}, {5000, 3 * umbral}}) {
+            int nf = tam.first, ng = tam.second;
+            vector<double> a = aleatorios(nf, gen), b = aleatorios(ng, gen);
+            // Coeficiente principal dominante: la serie inversa de rev(g) decrece y por
+            // encima del umbral se usa Newton
+            b[ng - 1] = ng + 1.0;
+            Polinomio f(nf - 1, a.data()), g(ng - 1, b.data()), q(0, a.data()), r(0, a.data());
+            f.dividir(g, q, r);
+            // Cota del error de q g: ng términos de tamaño hasta |q| |g|
+            double escala = f.normaMaxima() + ng * q.normaMaxima() * g.normaMaxima();
+            bool bien = diferencia(q * g + r, f) <= 1e-12 * escala &&
+                        (r.grado < g.grado || (g.grado == 0 && r.grado == 0 && r.coef[0] == 0.0));
+            if (nf >= ng) {
+                vector<double> qLarga(nf - ng + 1), rLarga(max(ng - 1, 1));
+                Polinomio::divisionLarga(a.data(), nf, b.data(), ng, qLarga.data(), rLarga.data());
+                Polinomio esperado(nf - ng, qLarga.data());
+                // El producto por FFT tiene error relativo al coeficiente mayor de f
+                bien &= diferencia(q, esperado) <= 1e-12 * max(f.normaMaxima(), esperado.normaMaxima());
+            }
+            comprobar(bien, "división " + to_string(nf) + " entre " + to_string(ng) + " coeficientes");
+        }
+
+        // rev(g) = 1 - 1.1x + ...: la serie inversa crece como 1.1^k, más allá de
+        // CRECIMIENTO_MAXIMO, y se usa la división larga, con el mismo resultado bit a bit
+        int nf = 4 * umbral, ng = 2 * umbral;
+        vector<double> a = aleatorios(nf, gen), b(ng, 0.0);
+        b[ng - 1] = 1.0;
+        b[ng - 2] = -1.1;
+        Polinomio f(nf - 1, a.data()), g(ng - 1, b.data()), q(0, a.data()), r(0, a.data());
+        f.dividir(g, q, r);
+        vector<double> qLarga(nf - ng + 1), rLarga(ng - 1);
+        Polinomio::divisionLarga(a.data(), nf, b.data(), ng, qLarga.data(), rLarga.data());
+        bool igual = q.grado == nf - ng && r.grado <= ng - 2;
+        for (int i = 0; igual && i <= q.grado; ++i)
+            igual = q.coef[i] == qLarga[i];
+        for (int i = 0; igual && i <= r.grado; ++i)
+            igual = r.coef[i] == rLarga[i];
+        comprobar(igual, "serie inversa inestable: vuelve a la división larga");
+
+        double c[5] = {1, -2, 3, 0.5, 1}, d[3] = {2, 0, 1}, ceros[3] = {0, 0, 0};
+        Polinomio F(4, c), G(2, d), Q(0, c), R(0, c);
+        F.dividir(G, Q, R);
+        comprobar(diferencia(F / G, Q) == 0.0 && diferencia(F % G, R) == 0.0, "operator/ y operator% iguales a dividir");
+        bool lanzo = false;
+        try {
+            F / Polinomio(2, ceros);
+        } catch (const domain_error&) {
+            lanzo = true;
+        }
+        comprobar(lanzo, "dividir entre el polinomio cero lanza domain_error");
+    }
+
+    // mcd recupera un factor común conocido y da 1 con polinomios coprimos
+    static void mcd() {
+        Polinomio m = desdeRaices({1, 2, -0.5, 3}).mcd(desdeRaices({2, -0.5, 7}));
+        comprobar(m.grado == 2 && diferencia(m, desdeRaices({2, -0.5})) < 1e-8,
+                  "mcd con las raíces comunes 2 y -0.5");
+
+        mt19937 gen(8);
+        Polinomio comun = desdeRaices({0.3, 0.7});
+        vector<double> a = aleatorios(7, gen), b = aleatorios(5, gen);
+        Polinomio m2 = (comun * Polinomio(6, a.data())).mcd(comun * Polinomio(4, b.data()));
+        comprobar(m2.grado == 2 && diferencia(m2, comun) < 1e-8, "mcd de dos múltiplos de (x - 0.3)(x - 0.7)");
+
+        Polinomio m3 = desdeRaices({1, 2}).mcd(desdeRaices({3, 4}));
+        comprobar(m3.grado == 0 && m3.coef[0] == 1.0, "mcd de polinomios coprimos es 1");
+    }
+
+    // Tiempo de raices() con coeficientes aleatorios de grado 100 a 10^4
+    static void medirRaices() {
+        mt19937 gen(6);
+        cout << "\n  grado    raices() ms   error hacia atrás" << endl;
+        for (int grado : {100, 1000, 3000, 10000}) {
+            vector<double> a = aleatorios(grado + 1, gen);
+            Polinomio p(grado, a.data());
+            auto t0 = chrono::steady_clock::now();
+            vector<complex<double>> z = p.raices();
+            double t = segundosDesde(t0);
+            cout << setw(7) << grado << fixed << setprecision(1) << setw(15) << t * 1e3
+                 << scientific << setprecision(2) << setw(20) << errorRaices(p, z) << endl;
+        }
+    }
+
+    // Suma y producto de grado 4 repetidos, con el número de reservas hechas
+    static void medirPequenos() {
+        double a[5] = {1, -2, 3, 0.5, 1}, b[5] = {2, 0, -1, 4, 3};
+        Polinomio A(4, a), B(4, b);
+        const int repeticiones = 1000000;
+        double suma = 0.0;
+        size_t antes = reservas;
+        auto t0 = chrono::steady_clock::now();
+        for (int i = 0; i < repeticiones; ++i) {
+            Polinomio S = A + B;
+            Polinomio P = A * B;
+            suma += S.coef[1] + P.coef[2];
+        }
+        double t = segundosDesde(t0);
+        cout << "\n10^6 x (A + B, A * B) de grado 4: " << fixed << setprecision(1) << t * 1e3 << " ms, "
+             << reservas - antes << " reservas (" << suma << ")" << endl;
+    }
+
+    // Tiempo de cada algoritmo con factores de n coeficientes, para situar los
+    // umbrales UMBRAL_KARATSUBA y UMBRAL_FFT. Se toma el mejor de varias repeticiones
+    static void medirProducto() {
+        mt19937 gen(2);
+        cout << "\n       n    directo us   Karatsuba us     FFT us" << endl;
+        for (int n : {16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 16384}) {
+            vector<double> a = aleatorios(n, gen), b = aleatorios(n, gen), r(2 * size_t(n) - 1);
+            int repeticiones = n <= 4096 ? 20 : 2;
+            auto mejor = [&](auto algoritmo) {
+                double t = 1e30;
+                for (int i = 0; i < repeticiones; ++i) {
+                    auto t0 = chrono::steady_clock::now();
+                    algoritmo(a.data(), n, b.data(), n, r.data());
+                    t = min(t, segundosDesde(t0));
+                }
+                return t * 1e6;
+            };
+            cout << setw(8) << n << fixed << setprecision(1) << setw(14) << mejor(Polinomio::productoDirecto)
+                 << setw(15) << mejor(Polinomio::productoKaratsuba) << setw(11) << mejor(Polinomio::productoFFT) << endl;
+        }
     }
 };
+
+int main(int argc, char** argv) {
+    PruebasPolinomio::producto();
+    PruebasPolinomio::evaluacion();
+    PruebasPolinomio::sinReservas();
+    PruebasPolinomio::raices();
+    PruebasPolinomio::division();
+    PruebasPolinomio::mcd();
+    if (argc > 1 && string(argv[1]) == "medir") {
+        PruebasPolinomio::medirProducto();
+        PruebasPolinomio::medirPequenos();
+        PruebasPolinomio::medirRaices();
+    }
+    cout << (fallos == 0 ? "Todas las pruebas pasaron" : "Hay pruebas que fallaron") << endl;
+    return fallos == 0 ? 0 : 1;
+}
+#endif
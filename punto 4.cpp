@@ -1,9 +1,23 @@
 #include <iostream>
 #include <cmath>
 #include <initializer_list>
+#include <cstddef>   // Para size_t
+#include <new>       // Para reservas de memoria alineadas
+#include <algorithm>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <cstring>   // Para memcpy
+#include <thread>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h> // Intrínsecos AVX2 / AVX-512
+#define COMPLEJO_X86 1
+#endif
 using namespace std;
 
-const double PI = 3.1415;
+constexpr double PI = 3.14159265358979323846;
 
 // -----------------------------------------------------------------------------
 // Clase para números complejos en forma binomial: a + ib
@@ -66,6 +80,1134 @@ public:
     polar toPolar() const;
 };
 
+// -----------------------------------------------------------------------------
+// Aproximaciones polinómicas de seno/coseno y atan2 escritas una sola vez sobre
+// vectores de GCC (V: doubles, VL: enteros de 64 bits del mismo ancho). Se
+// instancian dentro de los núcleos AVX2 y AVX-512, que les dan su ancho real.
+//  - senoCoseno: reducción de Cody-Waite a [-PI/4, PI/4] con PI/2 en tres partes
+//    y polinomios de Cephes. Error máximo medido: 1.6 ulp (cota 2 ulp) para
+//    |x| <= 1e6; los bloques fuera de ese rango o con NaN van a la versión escalar.
+//  - atan2: reducción a [0, 0.66] (con atan(t) = PI/4 + atan((t-1)/(t+1)) por
+//    encima) y aproximación racional de Cephes. Error máximo medido: 1.6 ulp
+//    (cota 2 ulp). Los bloques con infinitos o NaN van a la versión escalar.
+// Los resultados se devuelven por referencia: pasar vectores anchos por valor en
+// una función sin atributo target cambiaría la ABI.
+// -----------------------------------------------------------------------------
+template <class V, class VL>
+struct AproxVectorial {
+    static constexpr double LIMITE_SENO = 1e6;
+
+    __attribute__((always_inline))
+    static inline void senoCoseno(const V& x, V& s, V& c) {
+        const double magico = 6755399441055744.0; // 1.5 * 2^52: redondea al entero
+        V qf = x * (2 / PI) + magico;
+        VL q = (VL)qf;                            // Los bits bajos guardan el cuadrante
+        qf = qf - magico;
+        V r = x - qf * 1.57079625129699707031e+0;
+        r = r - qf * 7.54978941586159635335e-8;
+        r = r - qf * 5.39030285815811905290e-15;
+        V z = r * r;
+        V ps = ((((1.58962301576546568060e-10 * z - 2.50507477628578072866e-8) * z + 2.75573136213857245213e-6) * z
+                 - 1.98412698295895385996e-4) * z + 8.33333333332211858878e-3) * z - 1.66666666666666307295e-1;
+        V pc = ((((-1.13585365213876817300e-11 * z + 2.08757008419747316778e-9) * z - 2.75573141792967388112e-7) * z
+                 + 2.48015872888517045348e-5) * z - 1.38888888888730564116e-3) * z + 4.16666666666665929218e-2;
+        V sr = r + r * z * ps;
+        V cr = (1.0 - 0.5 * z) + z * z * pc;
+        // Cuadrante: 1 intercambia seno y coseno; 2 cambia el signo del seno y (q+1)&2 el del coseno
+        VL intercambio = (q & 1) != 0;
+        V s0 = intercambio ? cr : sr;
+        V c0 = intercambio ? sr : cr;
+        s = (V)((VL)s0 ^ ((q & 2) << 62));
+        c = (V)((VL)c0 ^ (((q + 1) & 2) << 62));
+    }
+
+    __attribute__((always_inline))
+    static inline void atan2(const V& y, const V& x, V& resultado) {
+        const VL signo = (VL){} + (long long)0x8000000000000000ULL;
+        const double masBits = 6.123233995736765886130e-17; // PI/2 - double(PI/2)
+        V ax = (V)((VL)x & ~signo), ay = (V)((VL)y & ~signo);
+        VL invertir = ay > ax;
+        V mayor = invertir ? ay : ax, menor = invertir ? ax : ay;
+        V t = menor / mayor;
+        t = mayor == 0 ? V{} : t;
+        VL grande = t > 0.66;
+        V u = grande ? (t - 1.0) / (t + 1.0) : t;
+        V z = u * u;
+        V p = (((-8.750608600031904122785e-1 * z - 1.615753718733365076637e+1) * z - 7.500855792314704667340e+1) * z
+               - 1.228866684490136173410e+2) * z - 6.485021904942025371773e+1;
+        V q = ((((z + 2.485846490142306297962e+1) * z + 1.650270098316988542046e+2) * z + 4.328810604912902668951e+2) * z
+               + 4.853903996359136964868e+2) * z + 1.945506571482613964425e+2;
+        V a = u + u * (z * p / q);
+        a = grande ? (PI / 4 + (a + 0.5 * masBits)) : a;
+        a = invertir ? ((PI / 2 - a) + masBits) : a;
+        a = ((VL)x & signo) != 0 ? ((PI - a) + 2 * masBits) : a;
+        resultado = (V)((VL)a | ((VL)y & signo));
+    }
+};
+
+// -----------------------------------------------------------------------------
+// Suma vectorial de un arreglo de doubles separando posiciones pares e impares:
+// con complejos intercalados (re, im, re, im, ...) da la parte real y la
+// imaginaria, y con un arreglo de una sola parte basta sumar ambos resultados.
+// En modo compensado cada carril acumula con TwoSum (suma de Neumaier sin
+// saltos), así que el error no crece con n. No compilar con -ffast-math: el
+// compilador eliminaría las compensaciones.
+// -----------------------------------------------------------------------------
+template <class V>
+struct SumaVectorial {
+    // s + c += x sin perder los bits bajos (TwoSum de Knuth)
+    template <class T>
+    __attribute__((always_inline))
+    static inline void dosSuma(T& s, T& c, const T& x) {
+        T t = s + x;
+        T z = t - s;
+        c += (s - (t - z)) + (x - z);
+        s = t;
+    }
+
+    __attribute__((always_inline))
+    static inline void sumar(const double* a, size_t n, bool compensada, double* s, double* c) {
+        constexpr size_t L = sizeof(V) / sizeof(double);
+        // Cuatro acumuladores independientes para no esperar la latencia de cada suma
+        V s0{}, s1{}, s2{}, s3{}, c0{}, c1{}, c2{}, c3{};
+        size_t i = 0;
+        for (; i + 4 * L <= n; i += 4 * L) {
+            V x0, x1, x2, x3;
+            memcpy(&x0, a + i, sizeof(V));
+            memcpy(&x1, a + i + L, sizeof(V));
+            memcpy(&x2, a + i + 2 * L, sizeof(V));
+            memcpy(&x3, a + i + 3 * L, sizeof(V));
+            if (compensada) {
+                dosSuma(s0, c0, x0);
+                dosSuma(s1, c1, x1);
+                dosSuma(s2, c2, x2);
+                dosSuma(s3, c3, x3);
+            } else {
+                s0 += x0;
+                s1 += x1;
+                s2 += x2;
+                s3 += x3;
+            }
+        }
+        if (compensada) {
+            dosSuma(s0, c0, s1);
+            dosSuma(s2, c2, s3);
+            dosSuma(s0, c0, s2);
+            c0 += (c1 + c2) + c3;
+        } else {
+            s0 += s1 + (s2 + s3);
+        }
+        // L es par: el carril k siempre recibe posiciones de la misma paridad
+        for (size_t k = 0; k < L; ++k) {
+            if (compensada) {
+                dosSuma(s[k % 2], c[k % 2], s0[k]);
+                c[k % 2] += c0[k];
+            } else {
+                s[k % 2] += s0[k];
+            }
+        }
+        for (; i < n; ++i) {
+            if (compensada)
+                dosSuma(s[i % 2], c[i % 2], a[i]);
+            else
+                s[i % 2] += a[i];
+        }
+    }
+};
+
+// -----------------------------------------------------------------------------
+// Núcleos para arreglos de complejos con despacho en tiempo de ejecución:
+// versión escalar portable y, en x86, AVX2+FMA y AVX-512 según la CPU.
+// Las partes reales e imaginarias viven en arreglos separados (re[], im[]).
+// -----------------------------------------------------------------------------
+class NucleosComplejo {
+public:
+    struct Tabla {
+        // c = a * b
+        void (*multiplicar)(const double* ar, const double* ai, const double* br, const double* bi,
+                            double* cr, double* ci, size_t n);
+        // c = a * conj(b)
+        void (*multiplicarConjugado)(const double* ar, const double* ai, const double* br, const double* bi,
+                                     double* cr, double* ci, size_t n);
+        // c += a * b
+        void (*multiplicarAcumular)(const double* ar, const double* ai, const double* br, const double* bi,
+                                    double* cr, double* ci, size_t n);
+        // m = |a|
+        void (*magnitud)(const double* ar, const double* ai, double* m, size_t n);
+        // Mariposas radix-2 de la FFT sobre h pares: t = w * b; b = a - t; a = a + t
+        void (*mariposas)(double* ar, double* ai, double* br, double* bi,
+                          const double* wr, const double* wi, size_t h);
+        // s = sen(a), c = cos(a)
+        void (*senoCoseno)(const double* a, double* s, double* c, size_t n);
+        // o = atan2(y, x)
+        void (*argumento)(const double* y, const double* x, double* o, size_t n);
+        // s[0], s[1] = sumas de las posiciones pares e impares de a; c[0], c[1] = sus
+        // compensaciones (solo en modo compensado). Acumula sobre lo que ya haya
+        void (*sumaParidad)(const double* a, size_t n, bool compensada, double* s, double* c);
+    };
+
+    static const Tabla& tabla() {
+        static const Tabla t = elegir();
+        return t;
+    }
+
+private:
+    static Tabla elegir() {
+#ifdef COMPLEJO_X86
+        if (__builtin_cpu_supports("avx512f"))
+            return {multiplicarAvx512, multiplicarConjugadoAvx512, multiplicarAcumularAvx512, magnitudAvx512,
+                    mariposasAvx512, senoCosenoAvx512, argumentoAvx512,
+                    sumaParidadAvx512};
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return {multiplicarAvx2, multiplicarConjugadoAvx2, multiplicarAcumularAvx2, magnitudAvx2,
+                    mariposasAvx2, senoCosenoAvx2, argumentoAvx2,
+                    sumaParidadAvx2};
+#endif
+        return {multiplicarEscalar, multiplicarConjugadoEscalar, multiplicarAcumularEscalar, magnitudEscalar,
+                mariposasEscalar, senoCosenoEscalar, argumentoEscalar,
+                sumaParidadEscalar};
+    }
+
+    // ------------------------------- Escalar -------------------------------
+
+    static void multiplicarEscalar(const double* ar, const double* ai, const double* br, const double* bi,
+                                   double* cr, double* ci, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            double re = ar[i] * br[i] - ai[i] * bi[i];
+            double im = ar[i] * bi[i] + ai[i] * br[i];
+            cr[i] = re;
+            ci[i] = im;
+        }
+    }
+
+    static void multiplicarConjugadoEscalar(const double* ar, const double* ai, const double* br, const double* bi,
+                                            double* cr, double* ci, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            double re = ar[i] * br[i] + ai[i] * bi[i];
+            double im = ai[i] * br[i] - ar[i] * bi[i];
+            cr[i] = re;
+            ci[i] = im;
+        }
+    }
+
+    static void multiplicarAcumularEscalar(const double* ar, const double* ai, const double* br, const double* bi,
+                                           double* cr, double* ci, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            cr[i] += ar[i] * br[i] - ai[i] * bi[i];
+            ci[i] += ar[i] * bi[i] + ai[i] * br[i];
+        }
+    }
+
+    static void magnitudEscalar(const double* ar, const double* ai, double* m, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            m[i] = sqrt(ar[i] * ar[i] + ai[i] * ai[i]);
+    }
+
+    static void mariposasEscalar(double* ar, double* ai, double* br, double* bi,
+                                 const double* wr, const double* wi, size_t h) {
+        for (size_t j = 0; j < h; ++j) {
+            double tr = wr[j] * br[j] - wi[j] * bi[j];
+            double ti = wr[j] * bi[j] + wi[j] * br[j];
+            br[j] = ar[j] - tr;
+            bi[j] = ai[j] - ti;
+            ar[j] += tr;
+            ai[j] += ti;
+        }
+    }
+
+    // GCC fusiona sin y cos del mismo argumento en una sola llamada a sincos
+    static void senoCosenoEscalar(const double* a, double* s, double* c, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            s[i] = sin(a[i]);
+            c[i] = cos(a[i]);
+        }
+    }
+
+    static void argumentoEscalar(const double* y, const double* x, double* o, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            o[i] = atan2(y[i], x[i]);
+    }
+
+    // Vectores de 16 bytes: GCC los baja a SSE2 o a código escalar según la arquitectura
+    typedef double V2 __attribute__((vector_size(16)));
+
+    static void sumaParidadEscalar(const double* a, size_t n, bool compensada, double* s, double* c) {
+        SumaVectorial<V2>::sumar(a, n, compensada, s, c);
+    }
+
+#ifdef COMPLEJO_X86
+    // ------------------------------ AVX2 + FMA ------------------------------
+    // Con FMA el resultado puede diferir del escalar en la última cifra (1 ulp).
+
+    __attribute__((target("avx2,fma")))
+    static void multiplicarAvx2(const double* ar, const double* ai, const double* br, const double* bi,
+                                double* cr, double* ci, size_t n) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d a = _mm256_loadu_pd(ar + i), b = _mm256_loadu_pd(ai + i);
+            __m256d c = _mm256_loadu_pd(br + i), d = _mm256_loadu_pd(bi + i);
+            _mm256_storeu_pd(cr + i, _mm256_fmsub_pd(a, c, _mm256_mul_pd(b, d)));
+            _mm256_storeu_pd(ci + i, _mm256_fmadd_pd(a, d, _mm256_mul_pd(b, c)));
+        }
+        multiplicarEscalar(ar + i, ai + i, br + i, bi + i, cr + i, ci + i, n - i);
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void multiplicarConjugadoAvx2(const double* ar, const double* ai, const double* br, const double* bi,
+                                         double* cr, double* ci, size_t n) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d a = _mm256_loadu_pd(ar + i), b = _mm256_loadu_pd(ai + i);
+            __m256d c = _mm256_loadu_pd(br + i), d = _mm256_loadu_pd(bi + i);
+            _mm256_storeu_pd(cr + i, _mm256_fmadd_pd(a, c, _mm256_mul_pd(b, d)));
+            _mm256_storeu_pd(ci + i, _mm256_fmsub_pd(b, c, _mm256_mul_pd(a, d)));
+        }
+        multiplicarConjugadoEscalar(ar + i, ai + i, br + i, bi + i, cr + i, ci + i, n - i);
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void multiplicarAcumularAvx2(const double* ar, const double* ai, const double* br, const double* bi,
+                                        double* cr, double* ci, size_t n) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d a = _mm256_loadu_pd(ar + i), b = _mm256_loadu_pd(ai + i);
+            __m256d c = _mm256_loadu_pd(br + i), d = _mm256_loadu_pd(bi + i);
+            __m256d re = _mm256_fnmadd_pd(b, d, _mm256_fmadd_pd(a, c, _mm256_loadu_pd(cr + i)));
+            __m256d im = _mm256_fmadd_pd(b, c, _mm256_fmadd_pd(a, d, _mm256_loadu_pd(ci + i)));
+            _mm256_storeu_pd(cr + i, re);
+            _mm256_storeu_pd(ci + i, im);
+        }
+        multiplicarAcumularEscalar(ar + i, ai + i, br + i, bi + i, cr + i, ci + i, n - i);
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void magnitudAvx2(const double* ar, const double* ai, double* m, size_t n) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d a = _mm256_loadu_pd(ar + i), b = _mm256_loadu_pd(ai + i);
+            _mm256_storeu_pd(m + i, _mm256_sqrt_pd(_mm256_fmadd_pd(a, a, _mm256_mul_pd(b, b))));
+        }
+        magnitudEscalar(ar + i, ai + i, m + i, n - i);
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void mariposasAvx2(double* ar, double* ai, double* br, double* bi,
+                              const double* wr, const double* wi, size_t h) {
+        size_t j = 0;
+        for (; j + 4 <= h; j += 4) {
+            __m256d xr = _mm256_loadu_pd(br + j), xi = _mm256_loadu_pd(bi + j);
+            __m256d cr = _mm256_loadu_pd(wr + j), ci = _mm256_loadu_pd(wi + j);
+            __m256d tr = _mm256_fmsub_pd(cr, xr, _mm256_mul_pd(ci, xi));
+            __m256d ti = _mm256_fmadd_pd(cr, xi, _mm256_mul_pd(ci, xr));
+            __m256d yr = _mm256_loadu_pd(ar + j), yi = _mm256_loadu_pd(ai + j);
+            _mm256_storeu_pd(br + j, _mm256_sub_pd(yr, tr));
+            _mm256_storeu_pd(bi + j, _mm256_sub_pd(yi, ti));
+            _mm256_storeu_pd(ar + j, _mm256_add_pd(yr, tr));
+            _mm256_storeu_pd(ai + j, _mm256_add_pd(yi, ti));
+        }
+        mariposasEscalar(ar + j, ai + j, br + j, bi + j, wr + j, wi + j, h - j);
+    }
+
+    typedef double V4 __attribute__((vector_size(32)));
+    typedef long long VL4 __attribute__((vector_size(32)));
+
+    __attribute__((target("avx2,fma")))
+    static void sumaParidadAvx2(const double* a, size_t n, bool compensada, double* s, double* c) {
+        SumaVectorial<V4>::sumar(a, n, compensada, s, c);
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void senoCosenoAvx2(const double* a, double* s, double* c, size_t n) {
+        const __m256d limite = _mm256_set1_pd(AproxVectorial<V4, VL4>::LIMITE_SENO);
+        const __m256d sinSigno = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d x = _mm256_loadu_pd(a + i);
+            // También atrapa NaN: la comparación no ordenada es verdadera
+            if (_mm256_movemask_pd(_mm256_cmp_pd(_mm256_and_pd(x, sinSigno), limite, _CMP_NLE_UQ))) {
+                senoCosenoEscalar(a + i, s + i, c + i, 4);
+                continue;
+            }
+            V4 vs, vc;
+            AproxVectorial<V4, VL4>::senoCoseno(x, vs, vc);
+            _mm256_storeu_pd(s + i, vs);
+            _mm256_storeu_pd(c + i, vc);
+        }
+        senoCosenoEscalar(a + i, s + i, c + i, n - i);
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void argumentoAvx2(const double* y, const double* x, double* o, size_t n) {
+        const __m256d infinito = _mm256_set1_pd(HUGE_VAL);
+        const __m256d sinSigno = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d vy = _mm256_loadu_pd(y + i), vx = _mm256_loadu_pd(x + i);
+            __m256d mayor = _mm256_max_pd(_mm256_and_pd(vy, sinSigno), _mm256_and_pd(vx, sinSigno));
+            if (_mm256_movemask_pd(_mm256_cmp_pd(mayor, infinito, _CMP_NLT_UQ))) {
+                argumentoEscalar(y + i, x + i, o + i, 4);
+                continue;
+            }
+            V4 a;
+            AproxVectorial<V4, VL4>::atan2(vy, vx, a);
+            _mm256_storeu_pd(o + i, a);
+        }
+        argumentoEscalar(y + i, x + i, o + i, n - i);
+    }
+
+    // ------------------------------- AVX-512 --------------------------------
+    // Colas con máscaras; maskz con máscara completa evita el falso aviso de
+    // variable sin inicializar que da _mm512_sqrt_pd en GCC 12.
+
+    __attribute__((target("avx512f")))
+    static __mmask8 mascaraCola(size_t resto) {
+        return __mmask8(resto >= 8 ? 0xFF : (1u << resto) - 1);
+    }
+
+    __attribute__((target("avx512f")))
+    static void multiplicarAvx512(const double* ar, const double* ai, const double* br, const double* bi,
+                                  double* cr, double* ci, size_t n) {
+        for (size_t i = 0; i < n; i += 8) {
+            __mmask8 k = mascaraCola(n - i);
+            __m512d a = _mm512_maskz_loadu_pd(k, ar + i), b = _mm512_maskz_loadu_pd(k, ai + i);
+            __m512d c = _mm512_maskz_loadu_pd(k, br + i), d = _mm512_maskz_loadu_pd(k, bi + i);
+            _mm512_mask_storeu_pd(cr + i, k, _mm512_fmsub_pd(a, c, _mm512_mul_pd(b, d)));
+            _mm512_mask_storeu_pd(ci + i, k, _mm512_fmadd_pd(a, d, _mm512_mul_pd(b, c)));
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    static void multiplicarConjugadoAvx512(const double* ar, const double* ai, const double* br, const double* bi,
+                                           double* cr, double* ci, size_t n) {
+        for (size_t i = 0; i < n; i += 8) {
+            __mmask8 k = mascaraCola(n - i);
+            __m512d a = _mm512_maskz_loadu_pd(k, ar + i), b = _mm512_maskz_loadu_pd(k, ai + i);
+            __m512d c = _mm512_maskz_loadu_pd(k, br + i), d = _mm512_maskz_loadu_pd(k, bi + i);
+            _mm512_mask_storeu_pd(cr + i, k, _mm512_fmadd_pd(a, c, _mm512_mul_pd(b, d)));
+            _mm512_mask_storeu_pd(ci + i, k, _mm512_fmsub_pd(b, c, _mm512_mul_pd(a, d)));
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    static void multiplicarAcumularAvx512(const double* ar, const double* ai, const double* br, const double* bi,
+                                          double* cr, double* ci, size_t n) {
+        for (size_t i = 0; i < n; i += 8) {
+            __mmask8 k = mascaraCola(n - i);
+            __m512d a = _mm512_maskz_loadu_pd(k, ar + i), b = _mm512_maskz_loadu_pd(k, ai + i);
+            __m512d c = _mm512_maskz_loadu_pd(k, br + i), d = _mm512_maskz_loadu_pd(k, bi + i);
+            __m512d re = _mm512_fnmadd_pd(b, d, _mm512_fmadd_pd(a, c, _mm512_maskz_loadu_pd(k, cr + i)));
+            __m512d im = _mm512_fmadd_pd(b, c, _mm512_fmadd_pd(a, d, _mm512_maskz_loadu_pd(k, ci + i)));
+            _mm512_mask_storeu_pd(cr + i, k, re);
+            _mm512_mask_storeu_pd(ci + i, k, im);
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    static void magnitudAvx512(const double* ar, const double* ai, double* m, size_t n) {
+        for (size_t i = 0; i < n; i += 8) {
+            __mmask8 k = mascaraCola(n - i);
+            __m512d a = _mm512_maskz_loadu_pd(k, ar + i), b = _mm512_maskz_loadu_pd(k, ai + i);
+            _mm512_mask_storeu_pd(m + i, k, _mm512_maskz_sqrt_pd(0xFF, _mm512_fmadd_pd(a, a, _mm512_mul_pd(b, b))));
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    static void mariposasAvx512(double* ar, double* ai, double* br, double* bi,
+                                const double* wr, const double* wi, size_t h) {
+        for (size_t j = 0; j < h; j += 8) {
+            __mmask8 k = mascaraCola(h - j);
+            __m512d xr = _mm512_maskz_loadu_pd(k, br + j), xi = _mm512_maskz_loadu_pd(k, bi + j);
+            __m512d cr = _mm512_maskz_loadu_pd(k, wr + j), ci = _mm512_maskz_loadu_pd(k, wi + j);
+            __m512d tr = _mm512_fmsub_pd(cr, xr, _mm512_mul_pd(ci, xi));
+            __m512d ti = _mm512_fmadd_pd(cr, xi, _mm512_mul_pd(ci, xr));
+            __m512d yr = _mm512_maskz_loadu_pd(k, ar + j), yi = _mm512_maskz_loadu_pd(k, ai + j);
+            _mm512_mask_storeu_pd(br + j, k, _mm512_sub_pd(yr, tr));
+            _mm512_mask_storeu_pd(bi + j, k, _mm512_sub_pd(yi, ti));
+            _mm512_mask_storeu_pd(ar + j, k, _mm512_add_pd(yr, tr));
+            _mm512_mask_storeu_pd(ai + j, k, _mm512_add_pd(yi, ti));
+        }
+    }
+
+    typedef double V8 __attribute__((vector_size(64)));
+    typedef long long VL8 __attribute__((vector_size(64)));
+
+    __attribute__((target("avx512f")))
+    static void sumaParidadAvx512(const double* a, size_t n, bool compensada, double* s, double* c) {
+        SumaVectorial<V8>::sumar(a, n, compensada, s, c);
+    }
+
+    // _mm512_abs_pd y _mm512_max_pd de GCC 12 también disparan el falso aviso de
+    // variable sin inicializar; por eso se usan and y maskz_max
+    __attribute__((target("avx512f")))
+    static __m512d valorAbsoluto(__m512d x) {
+        return _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(x), _mm512_set1_epi64(0x7FFFFFFFFFFFFFFFLL)));
+    }
+
+    __attribute__((target("avx512f")))
+    static void senoCosenoAvx512(const double* a, double* s, double* c, size_t n) {
+        const __m512d limite = _mm512_set1_pd(AproxVectorial<V8, VL8>::LIMITE_SENO);
+        for (size_t i = 0; i < n; i += 8) {
+            __mmask8 k = mascaraCola(n - i);
+            __m512d x = _mm512_maskz_loadu_pd(k, a + i);
+            if (_mm512_mask_cmp_pd_mask(k, valorAbsoluto(x), limite, _CMP_NLE_UQ)) {
+                senoCosenoEscalar(a + i, s + i, c + i, min<size_t>(8, n - i));
+                continue;
+            }
+            V8 vs, vc;
+            AproxVectorial<V8, VL8>::senoCoseno(x, vs, vc);
+            _mm512_mask_storeu_pd(s + i, k, vs);
+            _mm512_mask_storeu_pd(c + i, k, vc);
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    static void argumentoAvx512(const double* y, const double* x, double* o, size_t n) {
+        const __m512d infinito = _mm512_set1_pd(HUGE_VAL);
+        for (size_t i = 0; i < n; i += 8) {
+            __mmask8 k = mascaraCola(n - i);
+            __m512d vy = _mm512_maskz_loadu_pd(k, y + i), vx = _mm512_maskz_loadu_pd(k, x + i);
+            __m512d mayor = _mm512_maskz_max_pd(0xFF, valorAbsoluto(vy), valorAbsoluto(vx));
+            if (_mm512_mask_cmp_pd_mask(k, mayor, infinito, _CMP_NLT_UQ)) {
+                argumentoEscalar(y + i, x + i, o + i, min<size_t>(8, n - i));
+                continue;
+            }
+            V8 a;
+            AproxVectorial<V8, VL8>::atan2(vy, vx, a);
+            _mm512_mask_storeu_pd(o + i, k, a);
+        }
+    }
+#endif
+};
+
+// -----------------------------------------------------------------------------
+// Arreglo de complejos con partes real e imaginaria separadas (SoA), alineadas
+// a 64 bytes, para operar en bloque sobre millones de muestras.
+// La salida de cada operación puede coincidir con uno de los operandos.
+// -----------------------------------------------------------------------------
+class ArregloComplejo {
+private:
+    size_t n = 0;
+    double* re = nullptr;
+    double* im = nullptr;
+
+    static double* reservar(size_t cantidad) {
+        return static_cast<double*>(::operator new[](max<size_t>(cantidad, 1) * sizeof(double), align_val_t(64)));
+    }
+
+    static void liberar(double* p) {
+        ::operator delete[](p, align_val_t(64));
+    }
+
+public:
+    // Arreglo de 'cantidad' ceros
+    explicit ArregloComplejo(size_t cantidad = 0)
+        : n(cantidad), re(reservar(cantidad)), im(reservar(cantidad)) {
+        fill(re, re + n, 0.0);
+        fill(im, im + n, 0.0);
+    }
+
+    explicit ArregloComplejo(const vector<complex>& valores) : ArregloComplejo(valores.size()) {
+        for (size_t i = 0; i < n; ++i)
+            establecer(i, valores[i]);
+    }
+
+    ArregloComplejo(const ArregloComplejo& otro)
+        : n(otro.n), re(reservar(otro.n)), im(reservar(otro.n)) {
+        copy(otro.re, otro.re + n, re);
+        copy(otro.im, otro.im + n, im);
+    }
+
+    ArregloComplejo(ArregloComplejo&& otro) noexcept : n(otro.n), re(otro.re), im(otro.im) {
+        otro.n = 0;
+        otro.re = otro.im = nullptr;
+    }
+
+    ArregloComplejo& operator=(ArregloComplejo otro) noexcept {
+        swap(n, otro.n);
+        swap(re, otro.re);
+        swap(im, otro.im);
+        return *this;
+    }
+
+    ~ArregloComplejo() {
+        if (re) {
+            liberar(re);
+            liberar(im);
+        }
+    }
+
+    size_t tamano() const { return n; }
+
+    // Acceso directo a las partes real e imaginaria
+    const double* datosRe() const { return re; }
+    const double* datosIm() const { return im; }
+    double* datosRe() { return re; }
+    double* datosIm() { return im; }
+
+    complex operator[](size_t i) const {
+        return complex(re[i], im[i]);
+    }
+
+    void establecer(size_t i, const complex& c) {
+        re[i] = c.real();
+        im[i] = c.imag();
+    }
+
+    vector<complex> aVector() const {
+        vector<complex> v(n);
+        for (size_t i = 0; i < n; ++i)
+            v[i] = (*this)[i];
+        return v;
+    }
+
+    // salida[i] = this[i] * b[i]
+    void multiplicar(const ArregloComplejo& b, ArregloComplejo& salida) const {
+        NucleosComplejo::tabla().multiplicar(re, im, b.re, b.im, salida.re, salida.im, n);
+    }
+
+    // salida[i] = this[i] * conj(b[i]) (correlación cruzada)
+    void multiplicarConjugado(const ArregloComplejo& b, ArregloComplejo& salida) const {
+        NucleosComplejo::tabla().multiplicarConjugado(re, im, b.re, b.im, salida.re, salida.im, n);
+    }
+
+    // this[i] += a[i] * b[i]
+    void multiplicarAcumular(const ArregloComplejo& a, const ArregloComplejo& b) {
+        NucleosComplejo::tabla().multiplicarAcumular(a.re, a.im, b.re, b.im, re, im, n);
+    }
+
+    ArregloComplejo operator*(const ArregloComplejo& b) const {
+        ArregloComplejo c(n);
+        multiplicar(b, c);
+        return c;
+    }
+
+    void magnitudes(double* salida) const {
+        NucleosComplejo::tabla().magnitud(re, im, salida, n);
+    }
+
+    void argumentos(double* salida) const {
+        NucleosComplejo::tabla().argumento(im, re, salida, n);
+    }
+
+    // Conversión en bloque a forma polar (módulos y ángulos en arreglos separados)
+    void aPolar(double* modulos, double* angulos) const {
+        magnitudes(modulos);
+        argumentos(angulos);
+    }
+
+    // Conversión en bloque desde forma polar
+    static ArregloComplejo desdePolar(const double* modulos, const double* angulos, size_t cantidad) {
+        ArregloComplejo a(cantidad);
+        NucleosComplejo::tabla().senoCoseno(angulos, a.im, a.re, cantidad);
+        for (size_t i = 0; i < cantidad; ++i) {
+            a.re[i] *= modulos[i];
+            a.im[i] *= modulos[i];
+        }
+        return a;
+    }
+
+    // Las conversiones con objetos polar son plantillas para instanciarse donde
+    // la clase polar ya está completa
+    template <class P = polar>
+    vector<P> aPolares() const {
+        vector<double> modulos(n), angulos(n);
+        aPolar(modulos.data(), angulos.data());
+        vector<P> v;
+        v.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+            v.emplace_back(modulos[i], angulos[i]);
+        return v;
+    }
+
+    template <class P = polar>
+    static ArregloComplejo desdePolares(const vector<P>& valores) {
+        vector<double> modulos(valores.size()), angulos(valores.size());
+        for (size_t i = 0; i < valores.size(); ++i) {
+            modulos[i] = valores[i].modulo();
+            angulos[i] = valores[i].angulo();
+        }
+        return desdePolar(modulos.data(), angulos.data(), valores.size());
+    }
+};
+
+// Seno y coseno de muchos ángulos a la vez (núcleo vectorial, ver AproxVectorial)
+void senoCoseno(const double* angulos, double* senos, double* cosenos, size_t n) {
+    NucleosComplejo::tabla().senoCoseno(angulos, senos, cosenos, n);
+}
+
+// atan2(y[i], x[i]) en bloque
+void atan2Bloque(const double* y, const double* x, double* salida, size_t n) {
+    NucleosComplejo::tabla().argumento(y, x, salida, n);
+}
+
+// -----------------------------------------------------------------------------
+// Plan de FFT para un tamaño fijo. Los planes se calculan una sola vez y se
+// guardan en una caché compartida por tamaño (obtener()).
+//  - Potencias de 2: radix-2 iterativa en su sitio, con tabla de inversión de
+//    bits y factores de giro precalculados por etapa (contiguos para SIMD).
+//  - Otros tamaños: algoritmo de Bluestein (chirp-z), que reduce la DFT de
+//    tamaño n a una convolución cíclica de potencia de 2 >= 2n - 1.
+// Los datos se pasan como partes real e imaginaria separadas.
+// -----------------------------------------------------------------------------
+class PlanFFT {
+private:
+    size_t n;
+    bool potencia2;
+    vector<uint32_t> inversion;  // Permutación de inversión de bits
+    vector<double> giroRe;       // Factores de giro: la etapa de semitamaño h
+    vector<double> giroIm;       // ocupa las posiciones [h, 2h)
+
+    // Bluestein
+    vector<double> chirpRe, chirpIm;     // e^(-iπk²/n)
+    ArregloComplejo espectroChirp;       // FFT del chirp conjugado
+    shared_ptr<const PlanFFT> interno;   // Plan de potencia de 2
+
+    static constexpr double DOS_PI = 2 * PI;
+
+    explicit PlanFFT(size_t tamano) : n(tamano), potencia2((tamano & (tamano - 1)) == 0) {
+        if (potencia2)
+            prepararRadix2();
+        else
+            prepararBluestein();
+    }
+
+    void prepararRadix2() {
+        int bits = 0;
+        while ((size_t(1) << bits) < n)
+            ++bits;
+        inversion.assign(n, 0);
+        for (size_t i = 1; i < n; ++i)
+            inversion[i] = (inversion[i >> 1] >> 1) | (uint32_t(i & 1) << (bits - 1));
+        giroRe.assign(max<size_t>(n, 2), 1.0);
+        giroIm.assign(max<size_t>(n, 2), 0.0);
+        for (size_t h = 1; h < n; h *= 2)
+            for (size_t j = 0; j < h; ++j) {
+                double angulo = -DOS_PI * double(j) / double(2 * h);
+                giroRe[h + j] = cos(angulo);
+                giroIm[h + j] = sin(angulo);
+            }
+    }
+
+    void prepararBluestein() {
+        size_t m = 1;
+        while (m < 2 * n - 1)
+            m *= 2;
+        interno = obtener(m);
+        chirpRe.resize(n);
+        chirpIm.resize(n);
+        for (size_t k = 0; k < n; ++k) {
+            // k² se reduce módulo 2n para no perder precisión en el ángulo
+            uint64_t k2 = uint64_t(k) * k % (2 * uint64_t(n));
+            double angulo = -DOS_PI / 2 * double(k2) / double(n);
+            chirpRe[k] = cos(angulo);
+            chirpIm[k] = sin(angulo);
+        }
+        ArregloComplejo b(m);
+        for (size_t k = 0; k < n; ++k) {
+            b.establecer(k, complex(chirpRe[k], -chirpIm[k]));
+            if (k > 0)
+                b.establecer(m - k, complex(chirpRe[k], -chirpIm[k]));
+        }
+        interno->directa(b.datosRe(), b.datosIm());
+        espectroChirp = move(b);
+    }
+
+    void radix2(double* re, double* im) const {
+        for (size_t i = 0; i < n; ++i) {
+            size_t j = inversion[i];
+            if (i < j) {
+                swap(re[i], re[j]);
+                swap(im[i], im[j]);
+            }
+        }
+        // Las dos primeras etapas tienen giros triviales (1 y -i)
+        for (size_t k = 0; k + 1 < n; k += 2) {
+            double ar = re[k], ai = im[k];
+            re[k] = ar + re[k + 1];
+            im[k] = ai + im[k + 1];
+            re[k + 1] = ar - re[k + 1];
+            im[k + 1] = ai - im[k + 1];
+        }
+        for (size_t k = 0; k + 3 < n; k += 4) {
+            double ar = re[k], ai = im[k], br = re[k + 2], bi = im[k + 2];
+            re[k] = ar + br;
+            im[k] = ai + bi;
+            re[k + 2] = ar - br;
+            im[k + 2] = ai - bi;
+            ar = re[k + 1], ai = im[k + 1], br = im[k + 3], bi = -re[k + 3];
+            re[k + 1] = ar + br;
+            im[k + 1] = ai + bi;
+            re[k + 3] = ar - br;
+            im[k + 3] = ai - bi;
+        }
+        const NucleosComplejo::Tabla& t = NucleosComplejo::tabla();
+        for (size_t h = 4; h < n; h *= 2)
+            for (size_t k = 0; k < n; k += 2 * h)
+                t.mariposas(re + k, im + k, re + k + h, im + k + h, giroRe.data() + h, giroIm.data() + h, h);
+    }
+
+    void bluestein(double* re, double* im) const {
+        const NucleosComplejo::Tabla& t = NucleosComplejo::tabla();
+        size_t m = interno->tamano();
+        ArregloComplejo a(m);
+        t.multiplicar(re, im, chirpRe.data(), chirpIm.data(), a.datosRe(), a.datosIm(), n);
+        interno->directa(a.datosRe(), a.datosIm());
+        a.multiplicar(espectroChirp, a);
+        interno->inversa(a.datosRe(), a.datosIm());
+        t.multiplicar(a.datosRe(), a.datosIm(), chirpRe.data(), chirpIm.data(), re, im, n);
+    }
+
+public:
+    // Plan para el tamaño n, creado la primera vez y reutilizado después
+    static shared_ptr<const PlanFFT> obtener(size_t n) {
+        static mutex cerrojo;
+        static map<size_t, shared_ptr<const PlanFFT>> cache;
+        {
+            lock_guard<mutex> guardia(cerrojo);
+            auto it = cache.find(n);
+            if (it != cache.end())
+                return it->second;
+        }
+        // Se construye fuera del cerrojo: Bluestein pide a su vez otro plan
+        shared_ptr<const PlanFFT> plan(new PlanFFT(n));
+        lock_guard<mutex> guardia(cerrojo);
+        return cache.emplace(n, plan).first->second;
+    }
+
+    size_t tamano() const { return n; }
+
+    // DFT directa en su sitio: X[k] = sum x[j] e^(-2πijk/n)
+    void directa(double* re, double* im) const {
+        if (n <= 1)
+            return;
+        if (potencia2)
+            radix2(re, im);
+        else
+            bluestein(re, im);
+    }
+
+    // DFT inversa en su sitio, normalizada por 1/n. Intercambiar las partes real e
+    // imaginaria conjuga salvo un factor i, así que se reutiliza la transformada directa
+    void inversa(double* re, double* im) const {
+        directa(im, re);
+        double escala = 1.0 / double(n);
+        for (size_t i = 0; i < n; ++i) {
+            re[i] *= escala;
+            im[i] *= escala;
+        }
+    }
+};
+
+// FFT directa e inversa en su sitio sobre un arreglo de complejos de cualquier tamaño
+void fft(ArregloComplejo& a) {
+    PlanFFT::obtener(a.tamano())->directa(a.datosRe(), a.datosIm());
+}
+
+void fftInversa(ArregloComplejo& a) {
+    PlanFFT::obtener(a.tamano())->inversa(a.datosRe(), a.datosIm());
+}
+
+vector<complex> fft(const vector<complex>& x) {
+    ArregloComplejo a(x);
+    fft(a);
+    return a.aVector();
+}
+
+vector<complex> fftInversa(const vector<complex>& x) {
+    ArregloComplejo a(x);
+    fftInversa(a);
+    return a.aVector();
+}
+
+// -----------------------------------------------------------------------------
+// Plan de FFT para señales reales de longitud n par: las muestras pares e impares
+// se empaquetan como un complejo y se transforma con una FFT de tamaño n/2; los
+// giros e^(-2πik/n) que separan ambas mitades se guardan en el plan.
+// -----------------------------------------------------------------------------
+class PlanFFTReal {
+private:
+    size_t n;
+    shared_ptr<const PlanFFT> complejo; // Plan de tamaño n/2
+    vector<double> giroRe, giroIm;      // e^(-2πik/n), k = 0..n/2
+
+    explicit PlanFFTReal(size_t tamano) : n(tamano), complejo(PlanFFT::obtener(tamano / 2)) {
+        const double dosPi = 2 * PI;
+        giroRe.resize(n / 2 + 1);
+        giroIm.resize(n / 2 + 1);
+        for (size_t k = 0; k <= n / 2; ++k) {
+            giroRe[k] = cos(-dosPi * double(k) / double(n));
+            giroIm[k] = sin(-dosPi * double(k) / double(n));
+        }
+    }
+
+public:
+    // Plan para la longitud n (par), creado una vez y reutilizado después
+    static shared_ptr<const PlanFFTReal> obtener(size_t n) {
+        static mutex cerrojo;
+        static map<size_t, shared_ptr<const PlanFFTReal>> cache;
+        {
+            lock_guard<mutex> guardia(cerrojo);
+            auto it = cache.find(n);
+            if (it != cache.end())
+                return it->second;
+        }
+        shared_ptr<const PlanFFTReal> plan(new PlanFFTReal(n));
+        lock_guard<mutex> guardia(cerrojo);
+        return cache.emplace(n, plan).first->second;
+    }
+
+    size_t tamano() const { return n; }
+
+    // x: n muestras; Xre, Xim: n/2 + 1 coeficientes. La FFT de tamaño n/2 se hace
+    // dentro de la propia salida y se separa por parejas (k, n/2 - k) sin memoria extra
+    void directa(const double* x, double* Xre, double* Xim) const {
+        size_t m = n / 2;
+        for (size_t k = 0; k < m; ++k) {
+            Xre[k] = x[2 * k];
+            Xim[k] = x[2 * k + 1];
+        }
+        complejo->directa(Xre, Xim);
+        double r0 = Xre[0], i0 = Xim[0];
+        Xre[0] = r0 + i0;
+        Xim[0] = 0;
+        Xre[m] = r0 - i0;
+        Xim[m] = 0;
+        for (size_t k = 1; k <= m / 2; ++k) {
+            size_t j = m - k;
+            // E = FFT de las pares, O = FFT de las impares; X[k] = E + W^k O y
+            // X[m-k] = conj(E) + W^(m-k) conj(O)
+            double er = 0.5 * (Xre[k] + Xre[j]), ei = 0.5 * (Xim[k] - Xim[j]);
+            double or_ = 0.5 * (Xim[k] + Xim[j]), oi = -0.5 * (Xre[k] - Xre[j]);
+            Xre[k] = er + giroRe[k] * or_ - giroIm[k] * oi;
+            Xim[k] = ei + giroRe[k] * oi + giroIm[k] * or_;
+            Xre[j] = er + giroRe[j] * or_ + giroIm[j] * oi;
+            Xim[j] = -ei - giroRe[j] * oi + giroIm[j] * or_;
+        }
+    }
+
+    // Inversa: de los n/2 + 1 coeficientes a las n muestras (normalizada por 1/n)
+    void inversa(const double* Xre, const double* Xim, double* x) const {
+        size_t m = n / 2;
+        ArregloComplejo z(m);
+        double* zr = z.datosRe();
+        double* zi = z.datosIm();
+        for (size_t k = 0; k < m; ++k) {
+            // E[k] = (X[k] + conj(X[m-k])) / 2,  O[k] = (X[k] - conj(X[m-k])) W^-k / 2
+            double er = 0.5 * (Xre[k] + Xre[m - k]), ei = 0.5 * (Xim[k] - Xim[m - k]);
+            double dr = 0.5 * (Xre[k] - Xre[m - k]), di = 0.5 * (Xim[k] + Xim[m - k]);
+            double or_ = dr * giroRe[k] + di * giroIm[k];
+            double oi = di * giroRe[k] - dr * giroIm[k];
+            // z = E + i O
+            zr[k] = er - oi;
+            zi[k] = ei + or_;
+        }
+        complejo->inversa(zr, zi);
+        for (size_t k = 0; k < m; ++k) {
+            x[2 * k] = zr[k];
+            x[2 * k + 1] = zi[k];
+        }
+    }
+};
+
+// FFT de una señal real de longitud n: devuelve los n/2 + 1 coeficientes no
+// redundantes (el resto son conjugados). Las longitudes impares usan la FFT compleja
+ArregloComplejo fftReal(const vector<double>& x) {
+    size_t n = x.size();
+    ArregloComplejo X(n / 2 + 1);
+    if (n % 2 != 0 || n < 4) {
+        ArregloComplejo a(n);
+        copy(x.begin(), x.end(), a.datosRe());
+        fft(a);
+        copy(a.datosRe(), a.datosRe() + X.tamano(), X.datosRe());
+        copy(a.datosIm(), a.datosIm() + X.tamano(), X.datosIm());
+        return X;
+    }
+    PlanFFTReal::obtener(n)->directa(x.data(), X.datosRe(), X.datosIm());
+    return X;
+}
+
+// Inversa de fftReal: recibe los n/2 + 1 coeficientes y devuelve las n muestras reales
+vector<double> fftRealInversa(const ArregloComplejo& X, size_t n) {
+    vector<double> x(n);
+    if (n % 2 != 0 || n < 4) {
+        // Se reconstruye el espectro completo por simetría hermítica
+        ArregloComplejo a(n);
+        for (size_t k = 0; k < n; ++k)
+            a.establecer(k, k <= n / 2 ? X[k] : X[n - k].conj());
+        fftInversa(a);
+        copy(a.datosRe(), a.datosRe() + n, x.begin());
+        return x;
+    }
+    PlanFFTReal::obtener(n)->inversa(X.datosRe(), X.datosIm(), x.data());
+    return x;
+}
+
+// Convolución lineal de dos sucesiones reales por FFT en O(n log n); sirve,
+// por ejemplo, para multiplicar polinomios de coeficientes reales
+vector<double> convolucion(const vector<double>& a, const vector<double>& b) {
+    if (a.empty() || b.empty())
+        return {};
+    size_t largo = a.size() + b.size() - 1;
+    size_t n = 4;
+    while (n < largo)
+        n *= 2;
+    vector<double> pa(a), pb(b);
+    pa.resize(n, 0.0);
+    pb.resize(n, 0.0);
+    ArregloComplejo A = fftReal(pa), B = fftReal(pb);
+    A.multiplicar(B, A);
+    vector<double> c = fftRealInversa(A, n);
+    c.resize(largo);
+    return c;
+}
+
+// Convolución lineal de dos sucesiones complejas
+ArregloComplejo convolucion(const ArregloComplejo& a, const ArregloComplejo& b) {
+    if (a.tamano() == 0 || b.tamano() == 0)
+        return ArregloComplejo();
+    size_t largo = a.tamano() + b.tamano() - 1;
+    size_t n = 1;
+    while (n < largo)
+        n *= 2;
+    ArregloComplejo A(n), B(n);
+    copy(a.datosRe(), a.datosRe() + a.tamano(), A.datosRe());
+    copy(a.datosIm(), a.datosIm() + a.tamano(), A.datosIm());
+    copy(b.datosRe(), b.datosRe() + b.tamano(), B.datosRe());
+    copy(b.datosIm(), b.datosIm() + b.tamano(), B.datosIm());
+    fft(A);
+    fft(B);
+    A.multiplicar(B, A);
+    fftInversa(A);
+    ArregloComplejo c(largo);
+    copy(A.datosRe(), A.datosRe() + largo, c.datosRe());
+    copy(A.datosIm(), A.datosIm() + largo, c.datosIm());
+    return c;
+}
+
+// -----------------------------------------------------------------------------
+// acumula sobre rangos en tiempo de ejecución. El rango se parte en bloques de
+// tamaño fijo que se reparten entre hilos; cada bloque se suma con el núcleo
+// vectorial y los resultados parciales se combinan en árbol (por parejas). Como
+// los bloques no dependen del número de hilos, el resultado es el mismo con
+// cualquier número de hilos. ModoSuma::COMPENSADA usa sumas de Neumaier en cada
+// bloque y en el árbol, con error independiente de la longitud.
+// Para listas fijas de argumentos está acumulaPaquete, más abajo.
+// -----------------------------------------------------------------------------
+enum class ModoSuma { DIRECTA, COMPENSADA };
+
+class ReduccionParalela {
+private:
+    static constexpr size_t BLOQUE = size_t(1) << 15; // doubles por bloque
+
+    struct Parcial {
+        double s[2] = {0, 0};
+        double c[2] = {0, 0};
+    };
+
+    static void combinar(Parcial& a, const Parcial& b, bool compensada) {
+        for (int k = 0; k < 2; ++k) {
+            if (compensada) {
+                SumaVectorial<double>::dosSuma(a.s[k], a.c[k], b.s[k]);
+                a.c[k] += b.c[k];
+            } else {
+                a.s[k] += b.s[k];
+            }
+        }
+    }
+
+public:
+    // Sumas de las posiciones pares (par) e impares (impar) de datos[0, n)
+    static void sumar(const double* datos, size_t n, ModoSuma modo, unsigned hilos, double& par, double& impar) {
+        bool compensada = modo == ModoSuma::COMPENSADA;
+        size_t bloques = max<size_t>(1, (n + BLOQUE - 1) / BLOQUE);
+        vector<Parcial> parciales(bloques);
+        auto trabajar = [&](size_t desde, size_t hasta) {
+            const NucleosComplejo::Tabla& t = NucleosComplejo::tabla();
+            for (size_t b = desde; b < hasta; ++b) {
+                size_t inicio = b * BLOQUE;
+                t.sumaParidad(datos + inicio, min(BLOQUE, n - min(n, inicio)), compensada,
+                              parciales[b].s, parciales[b].c);
+            }
+        };
+        if (hilos == 0)
+            hilos = max(1u, thread::hardware_concurrency());
+        hilos = (unsigned)min<size_t>(hilos, bloques);
+        if (hilos <= 1) {
+            trabajar(0, bloques);
+        } else {
+            vector<thread> grupo;
+            for (unsigned h = 1; h < hilos; ++h)
+                grupo.emplace_back(trabajar, bloques * h / hilos, bloques * (h + 1) / hilos);
+            trabajar(0, bloques / hilos);
+            for (thread& t : grupo)
+                t.join();
+        }
+        // Reducción en árbol: en cada pasada el bloque i absorbe al i + paso
+        for (size_t paso = 1; paso < bloques; paso *= 2)
+            for (size_t i = 0; i + paso < bloques; i += 2 * paso)
+                combinar(parciales[i], parciales[i + paso], compensada);
+        par = parciales[0].s[0] + parciales[0].c[0];
+        impar = parciales[0].s[1] + parciales[0].c[1];
+    }
+};
+
+// Opciones de acumula: modo de suma y número de hilos (0 = todos los núcleos)
+struct OpcionesSuma {
+    ModoSuma modo = ModoSuma::DIRECTA;
+    unsigned hilos = 0;
+};
+
+inline OpcionesSuma opcionesSuma() { return {}; }
+inline OpcionesSuma opcionesSuma(ModoSuma modo) { return {modo, 0}; }
+inline OpcionesSuma opcionesSuma(ModoSuma modo, unsigned hilos) { return {modo, hilos}; }
+
+// complex es estándar de disposición y guarda exactamente (re, im), así que un
+// arreglo de complex se puede leer como doubles intercalados
+static_assert(sizeof(complex) == 2 * sizeof(double), "complex debe ser (re, im) sin relleno");
+
+complex acumulaRango(const complex* datos, size_t n, ModoSuma modo = ModoSuma::DIRECTA, unsigned hilos = 0) {
+    double re, im;
+    ReduccionParalela::sumar(reinterpret_cast<const double*>(datos), 2 * n, modo, hilos, re, im);
+    return complex(re, im);
+}
+
+// Las sobrecargas de acumula sobre rangos son plantillas con las opciones al final
+// (acumula(v), acumula(v, ModoSuma::COMPENSADA), acumula(v, modo, hilos)); las
+// listas fijas de argumentos van por acumulaPaquete
+template <class... Opciones>
+complex acumula(const vector<complex>& valores, Opciones... opciones) {
+    OpcionesSuma o = opcionesSuma(opciones...);
+    return acumulaRango(valores.data(), valores.size(), o.modo, o.hilos);
+}
+
+template <class... Opciones>
+complex acumula(const ArregloComplejo& a, Opciones... opciones) {
+    OpcionesSuma o = opcionesSuma(opciones...);
+    double parRe, imparRe, parIm, imparIm;
+    ReduccionParalela::sumar(a.datosRe(), a.tamano(), o.modo, o.hilos, parRe, imparRe);
+    ReduccionParalela::sumar(a.datosIm(), a.tamano(), o.modo, o.hilos, parIm, imparIm);
+    return complex(parRe + imparRe, parIm + imparIm);
+}
+
+// Suma de polares: se pasan en bloque a forma binomial con el seno/coseno
+// vectorial y se suman igual que los complex
+template <class P, class... Opciones>
+complex acumula(const vector<P>& valores, Opciones... opciones) {
+    vector<double> modulos(valores.size()), angulos(valores.size());
+    for (size_t i = 0; i < valores.size(); ++i) {
+        modulos[i] = valores[i].modulo();
+        angulos[i] = valores[i].angulo();
+    }
+    return acumula(ArregloComplejo::desdePolar(modulos.data(), angulos.data(), valores.size()), opciones...);
+}
+
+// Versión con expresión de pliegue (fold) para paquetes fijos de complex/polar:
+// el compilador la desenrolla por completo
+template <class... Args>
+complex acumulaPaquete(const Args&... args) {
+    return (complex() + ... + complex(args));
+}
+
 // -----------------------------------------------------------------------------
 // Clase para números complejos en forma polar: r * e^(iθ)
 // -----------------------------------------------------------------------------
@@ -75,7 +1217,395 @@ private:
     double theta; // Argumento (en radianes)
 
 public:
+    // Métodos de acceso
+    double modulo() const { return r; }
+    double angulo() const { return theta; }
+
+    // Lleva un ángulo al intervalo [-PI, PI] sin perder precisión (remainder es exacto)
+    static double normalizarAngulo(double a) {
+        return remainder(a, 2 * PI);
+    }
+
+    // Operaciones que no salen de la forma polar (sin senos, cosenos ni atan2)
+    polar multiplicar(const polar& p) const {
+        return polar(r * p.r, normalizarAngulo(theta + p.theta));
+    }
+
+    polar dividir(const polar& p) const {
+        return polar(r / p.r, normalizarAngulo(theta - p.theta));
+    }
+
+    // z^k = r^k e^(ikθ), con k real. El argumento se lleva primero a [-PI, PI]
+    // para obtener la rama principal con k no entero aunque el constructor haya
+    // recibido un ángulo fuera de ese intervalo: polar(1, 3PI/2)^0.5 da -PI/4
+    polar potencia(double k) const {
+        return polar(pow(r, k), normalizarAngulo(normalizarAngulo(theta) * k));
+    }
+
     // Constructores
     polar(double mod = 0, double ang = 0) : r(mod), theta(ang) {}
     polar(const complex& c) {
-        r = c.magnitu
\ No newline at end of file
+        r = c.magnitud();
+        theta = c.argumento();
+    }
+
+    // Conversión a forma binomial
+    complex toComplex() const {
+        return complex(r * cos(theta), r * sin(theta));
+    }
+
+    // Imprimir
+    void imprimir() const {
+        cout << r << " * e^(i" << theta << ")";
+    }
+};
+
+// Conversiones entre las dos formas; se definen aquí porque necesitan las dos
+// clases completas
+complex::complex(const polar& p) : re(p.modulo() * cos(p.angulo())), im(p.modulo() * sin(p.angulo())) {}
+
+polar complex::toPolar() const {
+    return polar(*this);
+}
+
+#ifdef COMPLEJO_PRUEBAS
+// Pruebas y mediciones. Se compilan con:
+//   g++ -std=c++17 -O2 -pthread -DCOMPLEJO_PRUEBAS "punto 4.cpp" -o pruebas
+// main devuelve 0 si todas las comprobaciones pasan; "./pruebas medir" ejecuta
+// además las mediciones de rendimiento.
+#include <chrono>
+#include <random>
+#include <string>
+#include <iomanip>
+
+static int fallos = 0;
+
+static void comprobar(bool condicion, const string& descripcion) {
+    cout << (condicion ? "[ok]    " : "[FALLO] ") << descripcion << endl;
+    if (!condicion)
+        ++fallos;
+}
+
+// fft() frente a la DFT directa en long double, ida y vuelta con fftInversa() y
+// fftReal() frente a fft() de la misma señal, para potencias de 2 y tamaños de
+// Bluestein
+static void pruebaFFT() {
+    mt19937 gen(2);
+    uniform_real_distribution<double> u(-1, 1);
+    for (size_t n : {1, 2, 3, 5, 8, 12, 17, 64, 100, 1000, 1024}) {
+        vector<complex> x(n);
+        for (auto& c : x)
+            c = complex(u(gen), u(gen));
+        vector<complex> X = fft(x), y = fftInversa(X);
+
+        double errDft = 0.0, errInv = 0.0, errReal = 0.0;
+        for (size_t k = 0; k < n; ++k) {
+            long double sr = 0, si = 0;
+            for (size_t j = 0; j < n; ++j) {
+                long double a = -2.0L * acosl(-1.0L) * ((j * k) % n) / n;
+                sr += x[j].real() * cosl(a) - x[j].imag() * sinl(a);
+                si += x[j].real() * sinl(a) + x[j].imag() * cosl(a);
+            }
+            errDft = max(errDft, double(fabsl(sr - X[k].real()) + fabsl(si - X[k].imag())));
+            errInv = max(errInv, (y[k] - x[k]).magnitud());
+        }
+
+        vector<double> r(n);
+        vector<complex> rc(n);
+        for (size_t i = 0; i < n; ++i) {
+            r[i] = u(gen);
+            rc[i] = complex(r[i], 0);
+        }
+        ArregloComplejo R = fftReal(r);
+        vector<complex> RC = fft(rc);
+        for (size_t k = 0; k <= n / 2; ++k)
+            errReal = max(errReal, (R[k] - RC[k]).magnitud());
+        vector<double> rr = fftRealInversa(R, n);
+        for (size_t i = 0; i < n; ++i)
+            errReal = max(errReal, fabs(rr[i] - r[i]));
+
+        double tolerancia = 1e-13 * max(1.0, log2(double(n))) * sqrt(double(n));
+        comprobar(errDft < tolerancia && errInv < tolerancia && errReal < tolerancia,
+                  "fft, inversa y real con n=" + to_string(n));
+    }
+}
+
+// convolucion() real y compleja frente a la suma directa
+static void pruebaConvolucion() {
+    mt19937 gen(3);
+    uniform_real_distribution<double> u(-1, 1);
+    for (size_t p : {1, 3, 50, 777}) {
+        vector<double> a(p), b(p + 5);
+        for (auto& v : a)
+            v = u(gen);
+        for (auto& v : b)
+            v = u(gen);
+        vector<double> c = convolucion(a, b);
+        ArregloComplejo C = convolucion(ArregloComplejo(vector<complex>(a.begin(), a.end())),
+                                        ArregloComplejo(vector<complex>(b.begin(), b.end())));
+        double err = 0.0;
+        for (size_t k = 0; k < c.size(); ++k) {
+            double s = 0.0;
+            for (size_t i = 0; i < a.size(); ++i)
+                if (k >= i && k - i < b.size())
+                    s += a[i] * b[k - i];
+            err = max(err, fabs(s - c[k]));
+            err = max(err, fabs(C[k].real() - s) + fabs(C[k].imag()));
+        }
+        comprobar(c.size() == a.size() + b.size() - 1 && err < 1e-11,
+                  "convolución de longitudes " + to_string(a.size()) + " y " + to_string(b.size()));
+    }
+}
+
+// Error en ulp de 'obtenido' respecto a 'referencia', calculada en long double con
+// libm, de modo que su propio redondeo apenas cuenta. Los NaN solo coinciden con NaN
+static double errorUlp(double obtenido, long double referencia) {
+    if (isnan(referencia) || isnan(obtenido))
+        return isnan(referencia) && isnan(obtenido) ? 0.0 : HUGE_VAL;
+    if (isinf(referencia) || (long double)obtenido == referencia)
+        return (long double)obtenido == referencia ? 0.0 : HUGE_VAL;
+    double d = fabs(double(referencia));
+    double ulp = nextafter(d, HUGE_VAL) - d;
+    if (ulp == 0 || d == 0)
+        ulp = nextafter(0.0, 1.0);
+    return double(fabsl((long double)obtenido - referencia) / ulp);
+}
+
+// senoCoseno() y atan2Bloque() frente a sin, cos y atan2 de libm: argumentos con
+// magnitudes de 1e-300 a 1e6 (la zona vectorial), más allá del límite, ceros,
+// infinitos y NaN (que pasan por la versión escalar). La cota documentada es 2 ulp
+// y el máximo medido, 1.6 ulp
+static void pruebaTrascendentes() {
+    mt19937 gen(8);
+    uniform_real_distribution<double> u(0, 1);
+    vector<double> x;
+    for (int i = 0; i < 200000; ++i) {
+        double m = i % 4 == 0 ? u(gen) * 2 * PI : pow(10.0, -300 + 306 * u(gen));
+        x.push_back(u(gen) < 0.5 ? -m : m);
+    }
+    for (double v : {0.0, -0.0, PI / 4, PI / 2, PI, 1e6, -1e6, 1e6 + 1, 1e20, HUGE_VAL, -HUGE_VAL, nan("")})
+        x.push_back(v);
+    size_t n = x.size();
+    vector<double> s(n), c(n);
+    senoCoseno(x.data(), s.data(), c.data(), n);
+    double peorSeno = 0.0, peorCoseno = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        peorSeno = max(peorSeno, errorUlp(s[i], sinl(x[i])));
+        peorCoseno = max(peorCoseno, errorUlp(c[i], cosl(x[i])));
+    }
+    cout << "        seno " << peorSeno << " ulp, coseno " << peorCoseno << " ulp" << endl;
+    comprobar(peorSeno <= 2.0 && peorCoseno <= 2.0, "senoCoseno dentro de 2 ulp de libm");
+
+    vector<double> y(n), xs(n), a(n);
+    for (size_t i = 0; i < n; ++i) {
+        double my = pow(10.0, -300 + 600 * u(gen)), mx = pow(10.0, -300 + 600 * u(gen));
+        if (i % 3 == 0)
+            mx = my * (0.5 + u(gen)); // Cocientes cerca de 1, donde cambia la reducción
+        y[i] = u(gen) < 0.5 ? -my : my;
+        xs[i] = u(gen) < 0.5 ? -mx : mx;
+    }
+    const double especiales[] = {0.0, -0.0, 1.0, -1.0, HUGE_VAL, -HUGE_VAL, nan("")};
+    size_t k = 0;
+    for (double ey : especiales)
+        for (double ex : especiales) {
+            y[k] = ey;
+            xs[k] = ex;
+            ++k;
+        }
+    atan2Bloque(y.data(), xs.data(), a.data(), n);
+    double peorAtan = 0.0;
+    bool signos = true;
+    for (size_t i = 0; i < n; ++i) {
+        long double r = atan2l(y[i], xs[i]);
+        peorAtan = max(peorAtan, errorUlp(a[i], r));
+        signos &= isnan(r) || signbit(a[i]) == signbit(r);
+    }
+    cout << "        atan2 " << peorAtan << " ulp" << endl;
+    comprobar(peorAtan <= 2.0 && signos, "atan2Bloque dentro de 2 ulp de libm, con ceros con signo");
+}
+
+static bool cerca(const complex& a, const complex& b, double tolerancia) {
+    return (a - b).magnitud() <= tolerancia * max(1.0, b.magnitud());
+}
+
+// Operaciones de polar frente a las de complex, rama principal de potencia() y
+// conversiones sueltas y en bloque
+static void pruebaPolar() {
+    polar p(2.0, 2.5), q(0.5, -2.0);
+    complex cp(p), cq(q);
+    comprobar(cerca(complex(p.multiplicar(q)), cp * cq, 1e-14) && cerca(complex(p.dividir(q)), cp / cq, 1e-14),
+              "multiplicar y dividir en forma polar");
+    comprobar(fabs(p.multiplicar(polar(1.0, 1.0)).angulo() - polar::normalizarAngulo(3.5)) < 1e-15 &&
+              fabs(p.multiplicar(polar(1.0, 1.0)).angulo()) <= PI,
+              "el ángulo del producto queda en [-PI, PI]");
+
+    polar raiz = polar(1.0, 3 * PI / 2).potencia(0.5);
+    comprobar(fabs(raiz.angulo() + PI / 4) < 1e-15 && fabs(raiz.modulo() - 1.0) < 1e-15,
+              "potencia(0.5) de polar(1, 3PI/2) da la rama principal -PI/4");
+    complex base(polar(2.0, 0.7));
+    comprobar(cerca(complex(polar(2.0, 0.7).potencia(3.0)), base * base * base, 1e-14),
+              "potencia entera igual al producto repetido");
+    comprobar(fabs(polar::normalizarAngulo(7 * PI) - PI) < 1e-15 || fabs(polar::normalizarAngulo(7 * PI) + PI) < 1e-15,
+              "normalizarAngulo(7PI) = ±PI");
+
+    complex z(-3.0, 4.0);
+    polar pz = z.toPolar();
+    comprobar(fabs(pz.modulo() - 5.0) < 1e-15 && cerca(pz.toComplex(), z, 1e-15), "ida y vuelta complex -> polar");
+
+    vector<polar> polares;
+    for (int i = 0; i < 37; ++i)
+        polares.emplace_back(0.1 * i, -3.0 + 0.17 * i);
+    ArregloComplejo A = ArregloComplejo::desdePolares(polares);
+    vector<polar> vuelta = A.aPolares();
+    bool iguales = vuelta.size() == polares.size();
+    for (size_t i = 0; i < polares.size(); ++i)
+        iguales &= cerca(A[i], complex(polares[i]), 1e-15) && cerca(complex(vuelta[i]), complex(polares[i]), 1e-15);
+    comprobar(iguales, "conversión en bloque entre polar y ArregloComplejo");
+}
+
+// Sumas con cancelación: pares (x, -x) de magnitud hasta 1e15 mezclados con unos,
+// de modo que la suma exacta es el número de unos
+static vector<complex> datosMalCondicionados(size_t n, double& exactaRe, double& exactaIm) {
+    mt19937_64 gen(11);
+    uniform_real_distribution<double> exponente(0, 15);
+    vector<complex> v;
+    v.reserve(n);
+    exactaRe = exactaIm = 0;
+    while (v.size() + 3 <= n) {
+        double x = pow(10.0, exponente(gen)), y = pow(10.0, exponente(gen));
+        v.emplace_back(x, -y);
+        v.emplace_back(1.0, 1.0);
+        v.emplace_back(-x, y);
+        exactaRe += 1;
+        exactaIm += 1;
+    }
+    shuffle(v.begin(), v.end(), gen);
+    return v;
+}
+
+// acumula da el mismo resultado, bit a bit, con 1, 2 y N hilos; COMPENSADA es más
+// precisa que DIRECTA con cancelación; y la suma de polares coincide con la de sus
+// formas binomiales
+static void pruebaAcumula() {
+    double exactaRe, exactaIm;
+    vector<complex> v = datosMalCondicionados(300000, exactaRe, exactaIm); // 18 bloques
+    ArregloComplejo A(v);
+    unsigned n = max(4u, thread::hardware_concurrency());
+    for (ModoSuma modo : {ModoSuma::DIRECTA, ModoSuma::COMPENSADA}) {
+        complex uno = acumula(v, modo, 1u), unoA = acumula(A, modo, 1u);
+        bool iguales = true;
+        for (unsigned hilos : {2u, 3u, n}) {
+            complex otro = acumula(v, modo, hilos), otroA = acumula(A, modo, hilos);
+            iguales &= otro.real() == uno.real() && otro.imag() == uno.imag() &&
+                       otroA.real() == unoA.real() && otroA.imag() == unoA.imag();
+        }
+        comprobar(iguales, string("acumula ") + (modo == ModoSuma::DIRECTA ? "directa" : "compensada") +
+                               " igual bit a bit con 1, 2, 3 y " + to_string(n) + " hilos");
+    }
+
+    complex directa = acumula(v, ModoSuma::DIRECTA, 1u), compensada = acumula(v, ModoSuma::COMPENSADA, 1u);
+    double errDirecta = max(fabs(directa.real() - exactaRe), fabs(directa.imag() - exactaIm));
+    double errCompensada = max(fabs(compensada.real() - exactaRe), fabs(compensada.imag() - exactaIm));
+    cout << "        suma exacta " << exactaRe << ", error directa " << errDirecta
+         << ", compensada " << errCompensada << endl;
+    comprobar(errCompensada < errDirecta && errCompensada <= 1e-6 * exactaRe,
+              "COMPENSADA más precisa que DIRECTA con cancelación");
+
+    vector<polar> polares;
+    complex referencia;
+    for (int i = 0; i < 100000; ++i) {
+        polares.emplace_back(1.0 + 0.001 * (i % 977), 0.37 * i);
+        referencia = referencia + complex(polares.back());
+    }
+    comprobar(cerca(acumula(polares), referencia, 1e-12) &&
+              cerca(acumula(polares, ModoSuma::COMPENSADA, 2u), referencia, 1e-12),
+              "acumula de vector<polar> igual a la suma de sus complex");
+    complex paquete = acumulaPaquete(complex(1, 2), polar(2.0, PI / 2), complex(-1, 0));
+    comprobar(cerca(paquete, complex(0, 4), 1e-15), "acumulaPaquete con complex y polar mezclados");
+}
+
+static double segundosDesde(chrono::steady_clock::time_point inicio) {
+    return chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+}
+
+// Tiempo de fft() y fftReal() con el plan ya en caché; la primera llamada incluye
+// el cálculo del plan. Los MFLOPS usan la cuenta habitual de 5 n log2(n). 10^6 no
+// es potencia de 2 y pasa por Bluestein.
+static void medirFFT() {
+    mt19937 gen(5);
+    uniform_real_distribution<double> u(-1, 1);
+    cout << "\n        n   primera ms   fft ms    MFLOPS   fftReal ms" << endl;
+    for (size_t n : {size_t(1) << 16, size_t(1) << 20, size_t(1) << 22, size_t(1000000)}) {
+        vector<complex> x(n);
+        for (auto& c : x)
+            c = complex(u(gen), u(gen));
+        ArregloComplejo A(x);
+        vector<double> r(n);
+        for (auto& v : r)
+            v = u(gen);
+        int repeticiones = n <= 65536 ? 200 : 5;
+
+        auto t0 = chrono::steady_clock::now();
+        fft(A);
+        double primera = segundosDesde(t0);
+
+        t0 = chrono::steady_clock::now();
+        for (int i = 0; i < repeticiones; ++i)
+            fft(A);
+        double compleja = segundosDesde(t0) / repeticiones;
+
+        t0 = chrono::steady_clock::now();
+        for (int i = 0; i < repeticiones; ++i)
+            fftReal(r);
+        double real = segundosDesde(t0) / repeticiones;
+
+        cout << setw(9) << n << fixed << setprecision(2) << setw(13) << primera * 1e3
+             << setw(9) << compleja * 1e3 << setprecision(0) << setw(10)
+             << 5.0 * n * log2(double(n)) / compleja * 1e-6 << setprecision(2) << setw(13) << real * 1e3 << endl;
+    }
+}
+
+// Suma de 10^8 complex en los dos modos con 1, 2, 4... hilos hasta los núcleos
+// disponibles. La suma va limitada por el ancho de banda de memoria, así que
+// escala hasta saturarlo, no necesariamente con cada núcleo.
+static void medirAcumula() {
+    const size_t n = 100000000;
+    vector<complex> v(n);
+    mt19937 gen(9);
+    uniform_real_distribution<double> u(-1, 1);
+    for (auto& c : v)
+        c = complex(u(gen), u(gen));
+    unsigned nucleos = max(1u, thread::hardware_concurrency());
+    vector<unsigned> cuentas;
+    for (unsigned h = 1; h < nucleos; h *= 2)
+        cuentas.push_back(h);
+    cuentas.push_back(nucleos);
+    cout << "\n    hilos   directa ms   Gmuestras/s   compensada ms   Gmuestras/s" << endl;
+    for (unsigned hilos : cuentas) {
+        cout << setw(9) << hilos;
+        for (ModoSuma modo : {ModoSuma::DIRECTA, ModoSuma::COMPENSADA}) {
+            acumula(v, modo, hilos); // calienta caché de páginas e hilos
+            auto t0 = chrono::steady_clock::now();
+            acumula(v, modo, hilos);
+            double t = segundosDesde(t0);
+            cout << fixed << setprecision(1) << setw(modo == ModoSuma::DIRECTA ? 13 : 16) << t * 1e3
+                 << setprecision(2) << setw(14) << n / t * 1e-9;
+        }
+        cout << endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    pruebaFFT();
+    pruebaConvolucion();
+    pruebaTrascendentes();
+    pruebaPolar();
+    pruebaAcumula();
+    if (argc > 1 && string(argv[1]) == "medir") {
+        medirFFT();
+        medirAcumula();
+    }
+    cout << (fallos == 0 ? "Todas las pruebas pasaron" : "Hay pruebas que fallaron") << endl;
+    return fallos == 0 ? 0 : 1;
+}
+#endif
@@ -4,6 +4,8 @@
 #include <sstream>
 #include <algorithm>
 #include <cmath>
+#include <climits>
+#include <thread>
 
 using namespace std;
 
@@ -69,11 +71,191 @@ public:
 
 class CPolinomio {
 private:
+    // Términos con coeficiente distinto de 0, en orden ascendente del exponente
+    // y sin exponentes repetidos
     vector<CTermino> polinomio;
 
+    static bool menorExponente(const CTermino& a, const CTermino& b) {
+        return a.obtenerExponente() < b.obtenerExponente();
+    }
+
+    // Mezcla lineal de 'a' (ordenado y sin repetidos) con 'b' (ordenado, puede
+    // repetir exponentes). Los coeficientes de un mismo exponente se suman en el
+    // orden a, b[i], b[i + 1], ..., igual que con asignarTermino uno a uno, y los
+    // que quedan en 0 se descartan
+    static void mezclar(const vector<CTermino>& a, const vector<CTermino>& b, vector<CTermino>& salida) {
+        salida.clear();
+        salida.reserve(a.size() + b.size());
+        size_t i = 0, j = 0;
+        while (i < a.size() || j < b.size()) {
+            if (j == b.size() || (i < a.size() && a[i].obtenerExponente() < b[j].obtenerExponente())) {
+                salida.push_back(a[i++]);
+                continue;
+            }
+            int exp = b[j].obtenerExponente();
+            double coef = 0;
+            if (i < a.size() && a[i].obtenerExponente() == exp)
+                coef = a[i++].obtenerCoeficiente();
+            for (; j < b.size() && b[j].obtenerExponente() == exp; j++)
+                coef += b[j].obtenerCoeficiente();
+            if (coef != 0)
+                salida.push_back(CTermino(coef, exp));
+        }
+    }
+
+    // Si el intervalo de exponentes del producto no pasa de este tamaño (ni del
+    // doble del número de productos), los coeficientes se acumulan en un arreglo
+    // denso indexado por exponente en lugar de usar el montículo
+    static const long long MAXIMO_DENSO = 1 << 22;
+
+    // Producto de a (na términos) por b (nb términos), ambos ordenados y sin
+    // repetidos; la salida queda ordenada y sin repetidos. En los dos métodos
+    // los productos de un mismo exponente se suman en orden creciente del índice
+    // en a, como en el doble bucle sobre a y b, así que el resultado no depende
+    // del método elegido
+    static void multiplicarTerminos(const CTermino* a, size_t na, const CTermino* b, size_t nb,
+                                    vector<CTermino>& salida) {
+        salida.clear();
+        if (na == 0 || nb == 0) {
+            return;
+        }
+        long long minimo = (long long)a[0].obtenerExponente() + b[0].obtenerExponente();
+        long long rango = (long long)a[na - 1].obtenerExponente() + b[nb - 1].obtenerExponente() - minimo + 1;
+        if (rango <= MAXIMO_DENSO && rango <= 2 * (long long)na * (long long)nb) {
+            multiplicarDenso(a, na, b, nb, minimo, rango, salida);
+        } else {
+            multiplicarMonton(a, na, b, nb, salida);
+        }
+    }
+
+    // Acumulación directa en un arreglo de 'rango' coeficientes: O(na nb + rango)
+    static void multiplicarDenso(const CTermino* a, size_t na, const CTermino* b, size_t nb,
+                                 long long minimo, long long rango, vector<CTermino>& salida) {
+        vector<double> suma(rango, 0.0);
+        for (size_t i = 0; i < na; i++) {
+            long long base = a[i].obtenerExponente() - minimo;
+            double c = a[i].obtenerCoeficiente();
+            for (size_t j = 0; j < nb; j++) {
+                suma[base + b[j].obtenerExponente()] += c * b[j].obtenerCoeficiente();
+            }
+        }
+        for (long long k = 0; k < rango; k++) {
+            if (suma[k] != 0) {
+                salida.push_back(CTermino(suma[k], int(k + minimo)));
+            }
+        }
+    }
+
+    // Mezcla de k vías de Johnson: un montículo guarda el siguiente producto de
+    // cada término del factor más corto y los productos salen en orden de
+    // exponente, así que se suman al salir y no hace falta ordenar después.
+    // Coste O(na nb log min(na, nb)) con memoria O(min(na, nb)) aparte de la salida
+    static void multiplicarMonton(const CTermino* a, size_t na, const CTermino* b, size_t nb,
+                                  vector<CTermino>& salida) {
+        struct Entrada {
+            int exponente;
+            size_t i, j; // Índices en a y en b
+        };
+        // Orden del montículo: exponente y, a igual exponente, índice en a
+        auto antes = [](const Entrada& x, const Entrada& y) {
+            return x.exponente != y.exponente ? x.exponente < y.exponente : x.i < y.i;
+        };
+        bool montonSobreA = na <= nb;
+        size_t n = min(na, nb);
+        vector<Entrada> monton(n);
+        for (size_t k = 0; k < n; k++) {
+            size_t i = montonSobreA ? k : 0, j = montonSobreA ? 0 : k;
+            monton[k] = {a[i].obtenerExponente() + b[j].obtenerExponente(), i, j};
+        }
+        // Los exponentes iniciales ya crecen con k, así que el arreglo es un montículo
+        
+        int exp = monton[0].exponente;
+        double coef = 0;
+        while (n > 0) {
+            Entrada e = monton[0];
+            if (e.exponente != exp) {
+                if (coef != 0) {
+                    salida.push_back(CTermino(coef, exp));
+                }
+                exp = e.exponente;
+                coef = 0;
+            }
+            coef += a[e.i].obtenerCoeficiente() * b[e.j].obtenerCoeficiente();
+            // El sucesor por el factor largo reemplaza a la cima; si no hay, la
+            // ocupa el último elemento. En ambos casos basta un hundimiento
+            if (montonSobreA ? ++e.j < nb : ++e.i < na) {
+                e.exponente = a[e.i].obtenerExponente() + b[e.j].obtenerExponente();
+            } else {
+                e = monton[--n];
+            }
+            size_t k = 0;
+            while (true) {
+                size_t hijo = 2 * k + 1;
+                if (hijo >= n) {
+                    break;
+                }
+                if (hijo + 1 < n && antes(monton[hijo + 1], monton[hijo])) {
+                    hijo++;
+                }
+                if (!antes(monton[hijo], e)) {
+                    break;
+                }
+                monton[k] = monton[hijo];
+                k = hijo;
+            }
+            if (n > 0) {
+                monton[k] = e;
+            }
+        }
+        if (coef != 0) {
+            salida.push_back(CTermino(coef, exp));
+        }
+    }
+
+    // Por debajo de este número de productos de términos no compensa crear hilos
+    static const long long MINIMO_PARALELO = 1 << 16;
+
+    // Mezcla de los productos parciales con exponente en [desde, hasta): en cada
+    // exponente se suman los parciales en orden, con una pasada lineal por cada uno
+    static void mezclarParciales(const vector<vector<CTermino>>& parciales, long long desde, long long hasta,
+                                 vector<CTermino>& salida) {
+        size_t k = parciales.size();
+        vector<size_t> pos(k), fin(k);
+        for (size_t p = 0; p < k; p++) {
+            auto menor = [](const CTermino& t, long long e) { return t.obtenerExponente() < e; };
+            pos[p] = lower_bound(parciales[p].begin(), parciales[p].end(), desde, menor) - parciales[p].begin();
+            fin[p] = lower_bound(parciales[p].begin(), parciales[p].end(), hasta, menor) - parciales[p].begin();
+        }
+        while (true) {
+            long long exp = LLONG_MAX;
+            for (size_t p = 0; p < k; p++) {
+                if (pos[p] < fin[p]) {
+                    exp = min(exp, (long long)parciales[p][pos[p]].obtenerExponente());
+                }
+            }
+            if (exp == LLONG_MAX) {
+                break;
+            }
+            double coef = 0;
+            for (size_t p = 0; p < k; p++) {
+                if (pos[p] < fin[p] && parciales[p][pos[p]].obtenerExponente() == exp) {
+                    coef += parciales[p][pos[p]++].obtenerCoeficiente();
+                }
+            }
+            if (coef != 0) {
+                salida.push_back(CTermino(coef, int(exp)));
+            }
+        }
+    }
+
 public:
     // Constructor que inicia un polinomio con cero términos
     CPolinomio() {}
+
+    // Constructor a partir de una lista de términos en cualquier orden
+    explicit CPolinomio(const vector<CTermino>& terminos) {
+        asignarTerminos(terminos);
+    }
     
     // Método para obtener el número de términos
     int obtenerNumeroTerminos() const {
@@ -90,62 +272,138 @@ public:
             return;
         }
         
-        // Buscar si ya existe un término con el mismo exponente
-        for (size_t i = 0; i < polinomio.size(); i++) {
-            if (polinomio[i].obtenerExponente() == exp) {
-                // Sumar coeficientes
-                double nuevoCoef = polinomio[i].obtenerCoeficiente() + coef;
-                if (nuevoCoef == 0) {
-                    // Si el resultado es 0, eliminar el término
-                    polinomio.erase(polinomio.begin() + i);
-                } else {
-                    // Reemplazar con el nuevo coeficiente
-                    polinomio[i].setCoeficiente(nuevoCoef);
-                }
-                return;
-            }
+        // Caso frecuente: exponente mayor que todos, se agrega al final en O(1)
+        if (polinomio.empty() || polinomio.back().obtenerExponente() < exp) {
+            polinomio.push_back(termino);
+            return;
         }
         
-        // Si no existe, agregarlo y ordenar
-        polinomio.push_back(termino);
+        // Búsqueda binaria del exponente; los términos se mantienen ordenados
+        auto pos = lower_bound(polinomio.begin(), polinomio.end(), termino, menorExponente);
+        if (pos != polinomio.end() && pos->obtenerExponente() == exp) {
+            // Sumar coeficientes
+            double nuevoCoef = pos->obtenerCoeficiente() + coef;
+            if (nuevoCoef == 0) {
+                // Si el resultado es 0, eliminar el término
+                polinomio.erase(pos);
+            } else {
+                // Reemplazar con el nuevo coeficiente
+                pos->setCoeficiente(nuevoCoef);
+            }
+            return;
+        }
         
-        // Ordenar en orden ascendente del exponente
-        sort(polinomio.begin(), polinomio.end(), 
-             [](const CTermino& a, const CTermino& b) {
-                 return a.obtenerExponente() < b.obtenerExponente();
-             });
+        // Si no existe, insertarlo en su posición
+        polinomio.insert(pos, termino);
     }
     
-    // Método para sumar dos polinomios
-    CPolinomio sumar(const CPolinomio& otro) const {
-        CPolinomio resultado;
-        
-        // Agregar todos los términos del primer polinomio
-        for (const auto& termino : polinomio) {
-            resultado.asignarTermino(termino);
+    // Método para asignar muchos términos a la vez, en cualquier orden. Se ordenan
+    // una sola vez y se mezclan con los existentes: O(k log k + n) para k términos
+    // nuevos, frente a una inserción en medio del vector por cada uno. El resultado
+    // es el mismo que asignarlos uno a uno en el orden dado
+    void asignarTerminos(const vector<CTermino>& terminos) {
+        vector<CTermino> nuevos;
+        nuevos.reserve(terminos.size());
+        for (const auto& termino : terminos) {
+            if (termino.obtenerCoeficiente() != 0) {
+                nuevos.push_back(termino);
+            }
         }
-        
-        // Agregar todos los términos del segundo polinomio
-        for (const auto& termino : otro.polinomio) {
-            resultado.asignarTermino(termino);
+        if (nuevos.empty()) {
+            return;
         }
         
+        // Orden estable: los coeficientes repetidos se suman en el orden dado
+        stable_sort(nuevos.begin(), nuevos.end(), menorExponente);
+        vector<CTermino> resultado;
+        mezclar(polinomio, nuevos, resultado);
+        polinomio.swap(resultado);
+    }
+    
+    // Método para sumar dos polinomios: como los dos están ordenados por
+    // exponente, basta una mezcla lineal O(n + m)
+    CPolinomio sumar(const CPolinomio& otro) const {
+        CPolinomio resultado;
+        mezclar(polinomio, otro.polinomio, resultado.polinomio);
         return resultado;
     }
     
     // Método para multiplicar dos polinomios
     CPolinomio multiplicar(const CPolinomio& otro) const {
         CPolinomio resultado;
+        multiplicarTerminos(polinomio.data(), polinomio.size(), otro.polinomio.data(), otro.polinomio.size(),
+                            resultado.polinomio);
+        return resultado;
+    }
+    
+    // Multiplicación con varios hilos (0 = todos los núcleos). El factor más
+    // largo se reparte en tramos contiguos; cada hilo multiplica su tramo por el
+    // otro factor en su propio vector de términos, y después cada hilo mezcla una
+    // franja de exponentes de todos esos parciales. Como los parciales se suman
+    // en otro orden, el resultado coincide exactamente con el de multiplicar(otro)
+    // cuando los coeficientes son enteros (y los productos exactos en double);
+    // con coeficientes no enteros puede diferir en el redondeo
+    CPolinomio multiplicar(const CPolinomio& otro, unsigned hilos) const {
+        const vector<CTermino>* a = &polinomio;
+        const vector<CTermino>* b = &otro.polinomio;
+        if (a->size() < b->size()) {
+            swap(a, b);
+        }
+        if (hilos == 0) {
+            hilos = max(1u, thread::hardware_concurrency());
+        }
+        hilos = unsigned(min<size_t>(hilos, a->size()));
+        if (hilos <= 1 || (long long)a->size() * (long long)b->size() < MINIMO_PARALELO) {
+            return multiplicar(otro);
+        }
         
-        // Multiplicar cada término del primer polinomio con cada término del segundo
-        for (const auto& t1 : polinomio) {
-            for (const auto& t2 : otro.polinomio) {
-                double nuevoCoef = t1.obtenerCoeficiente() * t2.obtenerCoeficiente();
-                int nuevoExp = t1.obtenerExponente() + t2.obtenerExponente();
-                resultado.asignarTermino(CTermino(nuevoCoef, nuevoExp));
+        // Productos parciales, uno por hilo
+        vector<vector<CTermino>> parciales(hilos);
+        vector<thread> grupo;
+        for (unsigned h = 0; h < hilos; h++) {
+            size_t desde = a->size() * h / hilos, hasta = a->size() * (h + 1) / hilos;
+            grupo.emplace_back(multiplicarTerminos, a->data() + desde, hasta - desde, b->data(), b->size(),
+                               ref(parciales[h]));
+        }
+        for (thread& t : grupo) {
+            t.join();
+        }
+        grupo.clear();
+        
+        // Franjas de exponentes con un número parecido de términos, a partir de
+        // una muestra de los parciales
+        vector<int> muestra;
+        for (const auto& parcial : parciales) {
+            size_t paso = max<size_t>(1, parcial.size() / (16 * hilos));
+            for (size_t k = 0; k < parcial.size(); k += paso) {
+                muestra.push_back(parcial[k].obtenerExponente());
             }
         }
+        sort(muestra.begin(), muestra.end());
+        vector<long long> cortes(hilos + 1);
+        cortes[0] = LLONG_MIN;
+        cortes[hilos] = LLONG_MAX;
+        for (unsigned h = 1; h < hilos; h++) {
+            cortes[h] = muestra.empty() ? LLONG_MIN : muestra[muestra.size() * h / hilos];
+        }
         
+        vector<vector<CTermino>> franjas(hilos);
+        for (unsigned h = 0; h < hilos; h++) {
+            grupo.emplace_back(mezclarParciales, cref(parciales), cortes[h], cortes[h + 1], ref(franjas[h]));
+        }
+        for (thread& t : grupo) {
+            t.join();
+        }
+        
+        CPolinomio resultado;
+        size_t total = 0;
+        for (const auto& franja : franjas) {
+            total += franja.size();
+        }
+        resultado.polinomio.reserve(total);
+        for (const auto& franja : franjas) {
+            resultado.polinomio.insert(resultado.polinomio.end(), franja.begin(), franja.end());
+        }
         return resultado;
     }
     
@@ -178,6 +436,7 @@ public:
 
 
 // Programa principal
+#ifndef CPOLINOMIO_PRUEBAS
 int main() {
     cout << "=== Sistema de Manipulacion de Polinomios ===" << endl << endl;
     
@@ -223,5 +482,259 @@ int main() {
     CPolinomio S2 = S.multiplicar(S);
     cout << "S(x)^2 = " << S2.toString() << endl;
     
+    // Construcción en bloque, con términos desordenados y repetidos:
+    // T(x) = x^4 - 3x + 2x^4 + 5 = 3x^4 - 3x + 5
+    CPolinomio T({CTermino(1, 4), CTermino(-3, 1), CTermino(2, 4), CTermino(5, 0)});
+    cout << "T(x) = " << T.toString() << endl;
+    
     return 0;
-}
\ No newline at end of file
+}
+#endif
+
+#ifdef CPOLINOMIO_PRUEBAS
+// Pruebas y mediciones; sustituyen al main de demostración. Se compilan con:
+//   g++ -std=c++17 -O2 -pthread -DCPOLINOMIO_PRUEBAS "punto 5.cpp" -o pruebas
+// main devuelve 0 si todas las comprobaciones pasan; "./pruebas medir" ejecuta
+// además las mediciones de rendimiento.
+#include <map>
+#include <random>
+#include <chrono>
+#include <iomanip>
+
+static int fallos = 0;
+
+static void comprobar(bool condicion, const string& descripcion) {
+    cout << (condicion ? "[ok]    " : "[FALLO] ") << descripcion << endl;
+    if (!condicion) {
+        ++fallos;
+    }
+}
+
+// Polinomio de referencia: los coeficientes se suman en el orden dado y los
+// términos que se anulan desaparecen, como en la implementación original
+static CPolinomio desdeMapa(const map<int, double>& mapa) {
+    CPolinomio p;
+    for (const auto& par : mapa) {
+        p.asignarTermino(CTermino(par.second, par.first));
+    }
+    return p;
+}
+
+static void sumarEnMapa(map<int, double>& mapa, const CTermino& t) {
+    if (t.obtenerCoeficiente() == 0) {
+        return;
+    }
+    double& coef = mapa[t.obtenerExponente()];
+    coef += t.obtenerCoeficiente();
+    if (coef == 0) {
+        mapa.erase(t.obtenerExponente());
+    }
+}
+
+// asignarTermino uno a uno, el constructor en bloque y asignarTerminos en dos
+// mitades dan lo mismo que la referencia, con repetidos y cancelaciones
+static void pruebaAsignar() {
+    mt19937 gen(5);
+    bool iguales = true;
+    for (int rep = 0; rep < 200; rep++) {
+        int n = 1 + gen() % 300, rango = 1 + gen() % 100;
+        vector<CTermino> terminos;
+        map<int, double> mapa;
+        for (int i = 0; i < n; i++) {
+            int c = int(gen() % 7) - 3;
+            terminos.push_back(CTermino(gen() % 3 == 0 ? c : c * 0.1, int(gen() % rango)));
+            sumarEnMapa(mapa, terminos.back());
+        }
+        CPolinomio unoAUno, bloque(terminos), mitades;
+        for (const auto& t : terminos) {
+            unoAUno.asignarTermino(t);
+        }
+        mitades.asignarTerminos(vector<CTermino>(terminos.begin(), terminos.begin() + n / 2));
+        mitades.asignarTerminos(vector<CTermino>(terminos.begin() + n / 2, terminos.end()));
+        string esperado = desdeMapa(mapa).toString();
+        iguales = iguales && unoAUno.toString() == esperado && bloque.toString() == esperado &&
+                  mitades.toString() == esperado && bloque.obtenerNumeroTerminos() == int(mapa.size());
+    }
+    comprobar(iguales, "asignarTermino, constructor en bloque y asignarTerminos");
+}
+
+// sumar() frente a la referencia, con un segundo sumando que anula una parte de
+// los términos del primero y con el opuesto completo, cuya suma es el polinomio vacío
+static void pruebaSumar() {
+    mt19937 gen(8);
+    bool iguales = true, vacios = true;
+    for (int rep = 0; rep < 100; rep++) {
+        int rango = 1 + gen() % 500;
+        vector<CTermino> ta, tb, opuestos;
+        map<int, double> mapa, mapaB;
+        for (int i = 0; i < 200; i++) {
+            int c = int(gen() % 7) - 3;
+            ta.push_back(CTermino(gen() % 2 == 0 ? c : c * 0.1, int(gen() % rango)));
+            sumarEnMapa(mapa, ta.back());
+        }
+        for (const auto& par : mapa) {
+            opuestos.push_back(CTermino(-par.second, par.first));
+            if (gen() % 2 == 0) {
+                tb.push_back(opuestos.back());
+                sumarEnMapa(mapaB, tb.back());
+            } else if (gen() % 2 == 0) {
+                tb.push_back(CTermino(int(gen() % 7) - 3, int(gen() % rango)));
+                sumarEnMapa(mapaB, tb.back());
+            }
+        }
+        CPolinomio a(ta), b(tb);
+        // Cada coeficiente de a se suma con el ya acumulado de b, como en la mezcla
+        for (const auto& par : mapaB) {
+            sumarEnMapa(mapa, CTermino(par.second, par.first));
+        }
+        CPolinomio suma = a.sumar(b);
+        iguales = iguales && suma.toString() == desdeMapa(mapa).toString() &&
+                  suma.obtenerNumeroTerminos() == int(mapa.size());
+        vacios = vacios && a.sumar(CPolinomio(opuestos)).obtenerNumeroTerminos() == 0 &&
+                 a.sumar(CPolinomio()).toString() == a.toString();
+    }
+    comprobar(iguales, "sumar con términos que se anulan");
+    comprobar(vacios, "sumar el opuesto da el polinomio vacío y sumar el vacío no cambia nada");
+}
+
+// multiplicar() denso y por montículo, y la versión con hilos, frente al producto
+// término a término; con coeficientes enteros todos deben coincidir exactamente
+static void pruebaMultiplicar() {
+    mt19937 gen(6);
+    for (int rango : {50, 100000}) {
+        vector<CTermino> ta, tb;
+        for (int i = 0; i < 300; i++) {
+            ta.push_back(CTermino(int(gen() % 19) - 9, int(gen() % rango)));
+            tb.push_back(CTermino(int(gen() % 19) - 9, int(gen() % rango)));
+        }
+        CPolinomio a(ta), b(tb);
+        map<int, double> mapa;
+        for (const auto& x : ta) {
+            for (const auto& y : tb) {
+                mapa[x.obtenerExponente() + y.obtenerExponente()] += x.obtenerCoeficiente() * y.obtenerCoeficiente();
+            }
+        }
+        for (auto it = mapa.begin(); it != mapa.end();) {
+            it = it->second == 0 ? mapa.erase(it) : next(it);
+        }
+        string esperado = desdeMapa(mapa).toString();
+        comprobar(a.multiplicar(b).toString() == esperado && a.multiplicar(b, 4).toString() == esperado,
+                  "multiplicar con exponentes hasta " + to_string(rango));
+    }
+}
+
+// La implementación original de asignarTermino: búsqueda lineal del exponente y
+// una ordenación completa del vector por cada término nuevo
+static void asignarOriginal(vector<CTermino>& polinomio, const CTermino& termino) {
+    if (termino.obtenerCoeficiente() == 0) {
+        return;
+    }
+    for (size_t i = 0; i < polinomio.size(); i++) {
+        if (polinomio[i].obtenerExponente() == termino.obtenerExponente()) {
+            double nuevoCoef = polinomio[i].obtenerCoeficiente() + termino.obtenerCoeficiente();
+            if (nuevoCoef == 0) {
+                polinomio.erase(polinomio.begin() + i);
+            } else {
+                polinomio[i].setCoeficiente(nuevoCoef);
+            }
+            return;
+        }
+    }
+    polinomio.push_back(termino);
+    sort(polinomio.begin(), polinomio.end(), [](const CTermino& a, const CTermino& b) {
+        return a.obtenerExponente() < b.obtenerExponente();
+    });
+}
+
+static double milisegundosDesde(chrono::steady_clock::time_point inicio) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+}
+
+// Construcción de polinomios de 10^4 a 10^6 términos con exponentes aleatorios:
+// la implementación original (solo hasta 3 * 10^4 términos, es cuadrática),
+// asignarTermino uno a uno (hasta 10^5), el constructor en bloque y
+// asignarTermino con exponentes ascendentes, que agrega al final en O(1)
+static void medirConstruccion() {
+    mt19937 gen(7);
+    cout << endl << "  terminos   original ms   uno a uno ms   bloque ms   ascendente ms" << endl;
+    for (int n : {10000, 30000, 100000, 1000000}) {
+        vector<CTermino> aleatorios, ascendentes;
+        for (int i = 0; i < n; i++) {
+            aleatorios.push_back(CTermino(1 + gen() % 9, int(gen() % (4u * n))));
+            ascendentes.push_back(CTermino(1 + gen() % 9, 3 * i));
+        }
+        
+        cout << setw(10) << n << fixed << setprecision(1);
+        if (n <= 30000) {
+            vector<CTermino> original;
+            auto t0 = chrono::steady_clock::now();
+            for (const auto& t : aleatorios) {
+                asignarOriginal(original, t);
+            }
+            cout << setw(14) << milisegundosDesde(t0);
+        } else {
+            cout << setw(14) << "-";
+        }
+        
+        if (n <= 100000) {
+            CPolinomio unoAUno;
+            auto t0 = chrono::steady_clock::now();
+            for (const auto& t : aleatorios) {
+                unoAUno.asignarTermino(t);
+            }
+            cout << setw(15) << milisegundosDesde(t0);
+        } else {
+            cout << setw(15) << "-";
+        }
+        
+        auto t0 = chrono::steady_clock::now();
+        CPolinomio bloque(aleatorios);
+        cout << setw(12) << milisegundosDesde(t0);
+        
+        CPolinomio ascendente;
+        t0 = chrono::steady_clock::now();
+        for (const auto& t : ascendentes) {
+            ascendente.asignarTermino(t);
+        }
+        cout << setw(16) << milisegundosDesde(t0) << endl;
+    }
+}
+
+// Producto de dos polinomios de 10^4 términos (10^8 productos de términos) con
+// exponentes densos y dispersos hasta 10^6 y 10^7, con un hilo y con todos los
+// núcleos. Más dispersos, el resultado pasa de 10^7 términos y la memoria que ocupa
+// domina la medición
+static void medirProducto() {
+    mt19937 gen(9);
+    const int n = 10000;
+    cout << endl << "    exponentes hasta   terminos resultado   1 hilo ms   hilos ms" << endl;
+    for (int rango : {2 * n, 1000000, 10000000}) {
+        vector<CTermino> ta, tb;
+        for (int i = 0; i < n; i++) {
+            ta.push_back(CTermino(1 + gen() % 9, int(gen() % unsigned(rango))));
+            tb.push_back(CTermino(1 + gen() % 9, int(gen() % unsigned(rango))));
+        }
+        CPolinomio a(ta), b(tb);
+        auto t0 = chrono::steady_clock::now();
+        int terminos = a.multiplicar(b).obtenerNumeroTerminos();
+        double uno = milisegundosDesde(t0);
+        t0 = chrono::steady_clock::now();
+        terminos += a.multiplicar(b, 0).obtenerNumeroTerminos();
+        double varios = milisegundosDesde(t0);
+        cout << setw(20) << rango << setw(21) << terminos / 2 << fixed << setprecision(1)
+             << setw(12) << uno << setw(11) << varios << endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    pruebaAsignar();
+    pruebaSumar();
+    pruebaMultiplicar();
+    if (argc > 1 && string(argv[1]) == "medir") {
+        medirConstruccion();
+        medirProducto();
+    }
+    cout << (fallos == 0 ? "Todas las pruebas pasaron" : "Hay pruebas que fallaron") << endl;
+    return fallos == 0 ? 0 : 1;
+}
+#endif